@@ -13,6 +13,8 @@
 #include "utils/log.h"
 #include "utils/table.h"
 
+#include <unordered_map>
+
 using namespace std;
 
 using symbol_t = string;
@@ -40,6 +42,30 @@ reduced_product_t Grammar::reduceProduct(const product_t &p) const
     return res;
 }
 
+SymbolInterner::SymbolInterner(const symset_t &terminals, const symset_t &nonTerms)
+{
+    names.reserve(terminals.size() + nonTerms.size());
+    for (auto &t : terminals)
+    {
+        ids[t] = names.size();
+        names.push_back(t);
+    }
+    termCount = names.size();
+    for (auto &v : nonTerms)
+    {
+        assert(!_find(ids, v), format("SymbolInterner: $ is both terminal and non-terminal.", v));
+        ids[v] = names.size();
+        names.push_back(v);
+    }
+}
+
+void Grammar::internSymbols()
+{
+    symtab = SymbolInterner(terminals, nonTerms);
+    info << "Grammar: " << symtab.terminalCount() << " terminals and "
+         << symtab.nonTermCount() << " non-terminals interned." << endl;
+}
+
 void Grammar::updateStartProduct()
 {
     startProduct = make_pair(symStart, *rules.at(symStart).begin());
@@ -128,7 +154,7 @@ void Grammar::extractLeftCommonFactor()
         const symbol_t &left = tree.first;
         tt_node_ptr_t &root = tree.second;
         root->postorder(
-            [&](tt_node_t node)
+            [&](const tt_node_t &node)
             {
                 if (node.size() > 1 && node.data.index != 0)
                 {
@@ -144,7 +170,7 @@ void Grammar::extractLeftCommonFactor()
                     prefix.push_back(newNonTerm);
                     rules[left].insert(prefix);
                     node.foreach (
-                        [&](tt_node_t child)
+                        [&](const tt_node_t &child)
                         {
                             // 对于每个子节点，将其所代表的子产生式加入新的规则
                             symstr_t suffix;
@@ -215,7 +241,7 @@ vector<token> Grammar::transferTokens(const vector<token> &tokens) const
         if (_find(terminals, t.value))
         {
             res.push_back(token(
-                make_shared<symbol_t>(t.value),
+                tokTypeOf(internTokType(t.value)),
                 t.value,
                 t.line,
                 t.col));
@@ -224,7 +250,7 @@ vector<token> Grammar::transferTokens(const vector<token> &tokens) const
         {
             res.push_back(
                 token(
-                    make_shared<symbol_t>(tok2sym.at(t.type)),
+                    tokTypeOf(internTokType(tok2sym.at(t.type))),
                     t.value,
                     t.line,
                     t.col));
@@ -236,4 +262,54 @@ vector<token> Grammar::transferTokens(const vector<token> &tokens) const
         }
     }
     return res;
-}
\ No newline at end of file
+}
+TokenMapper::TokenMapper(const Grammar &grammar)
+{
+    for (auto &term : grammar.terminals)
+        termIds[term] = internTokType(term);
+    for (auto &pair : grammar.tok2sym)
+        if (pair.first != nullptr)
+            typeIds[internTokType(pair.first)] = internTokType(pair.second);
+}
+
+bool TokenMapper::map(tok_id_t &type, string_view value) const
+{
+    string visible;
+    if (value.find_first_of("\n\t\r\v\f") != string_view::npos)
+    {
+        // 与物化后的token保持一致，按可视化后的值匹配字面量终结符
+        visible = string(value);
+        value = visualize(visible);
+    }
+    auto termIt = termIds.find(value);
+    if (termIt != termIds.end())
+    {
+        type = termIt->second;
+        return true;
+    }
+    auto typeIt = typeIds.find(type);
+    if (typeIt != typeIds.end())
+    {
+        type = typeIt->second;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 将紧凑词法单元序列的类型就地替换为文法符号
+ * 终结符和类型映射均预先转换为编号，逐词法单元只做一次查表，不分配内存
+ */
+void Grammar::transferTokens(TokenStream &tokens) const
+{
+    info << "Transferring tokens..." << endl;
+    TokenMapper mapper(*this);
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        tok_id_t type = tokens.typeId(i);
+        if (mapper.map(type, tokens.value(i)))
+            tokens.retype(i, type);
+        else
+            warn << "Grammar::transferTokens: Unknown token: " << tokens.value(i) << endl;
+    }
+}
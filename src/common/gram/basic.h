@@ -11,6 +11,7 @@
 #pragma once
 
 #include "common/token.h"
+#include "common/tok_stream.h"
 #include "common/tree/tree.h"
 #include "algorithm"
 
@@ -18,6 +19,9 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
 
 #define EPSILON "$" // 用于表示空串
 #define SYM_END "#" // 用于表示输入串结束
@@ -51,6 +55,64 @@ constexpr coord_t<row_t, col_t> mkcrd(const row_t &a, const col_t &b)
     return coord_t<row_t, col_t>(a, b);
 }
 
+using sym_id_t = uint32_t;
+constexpr sym_id_t SYM_NONE = UINT32_MAX;
+
+/**
+ * @brief 文法符号表
+ * 将终结符和非终结符映射为连续的整数编号，名称只在打印时使用
+ * 终结符编号为 [0, terminalCount)，非终结符编号为 [terminalCount, size)
+ * 两类符号内部均按名称的字典序编号，因此按编号遍历与按symset_t遍历的顺序一致
+ */
+class SymbolInterner
+{
+    std::vector<symbol_t> names;
+    std::unordered_map<symbol_t, sym_id_t> ids;
+    size_t termCount = 0;
+
+public:
+    SymbolInterner() = default;
+    SymbolInterner(const symset_t &terminals, const symset_t &nonTerms);
+
+    sym_id_t id(const symbol_t &s) const
+    {
+        auto it = ids.find(s);
+        return it == ids.end() ? SYM_NONE : it->second;
+    }
+    const symbol_t &name(sym_id_t i) const
+    {
+        return names[i];
+    }
+    bool isTerminal(sym_id_t i) const
+    {
+        return i < termCount;
+    }
+    bool isNonTerm(sym_id_t i) const
+    {
+        return i >= termCount && i < names.size();
+    }
+    size_t size() const
+    {
+        return names.size();
+    }
+    size_t terminalCount() const
+    {
+        return termCount;
+    }
+    size_t nonTermCount() const
+    {
+        return names.size() - termCount;
+    }
+    sym_id_t nonTermBase() const
+    {
+        return termCount;
+    }
+    bool empty() const
+    {
+        return names.empty();
+    }
+};
+
 class Grammar
 {
 
@@ -68,6 +130,8 @@ public:
     std::map<product_t, semantic_t> semMap;
     std::map<symbol_t, prec_assoc_t> precMap;
 
+    SymbolInterner symtab; // 符号编号表，文法定义完成后由internSymbols生成
+
     Grammar() { terminals.insert(SYM_END); }
     Grammar(const Grammar &g)
     {
@@ -81,9 +145,11 @@ public:
         tok2sym = g.tok2sym;
         semMap = g.semMap;
         precMap = g.precMap;
+        symtab = g.symtab;
     }
     reduced_product_t reduceProduct(const product_t &p) const;
     void updateStartProduct();
+    void internSymbols();
     void eliminateLeftRecursion();
     void extractLeftCommonFactor();
     void printRules() const;
@@ -91,6 +157,23 @@ public:
     void printNonTerms() const;
     void printSemanticMarks() const;
     std::vector<token> transferTokens(const std::vector<token> &tokens) const;
+    void transferTokens(TokenStream &tokens) const;
+};
+
+/**
+ * @brief 词法单元到文法终结符的映射
+ * 字面量终结符按值匹配，其余按词法单元类型匹配，两者均预先转换为类型编号
+ * 构造后只读，可以在多个线程中同时使用；文法须在映射使用期间保持有效
+ */
+class TokenMapper
+{
+    std::unordered_map<std::string_view, tok_id_t> termIds;
+    std::unordered_map<tok_id_t, tok_id_t> typeIds;
+
+public:
+    TokenMapper(const Grammar &grammar);
+    // 将type替换为对应文法符号的类型编号，不属于文法的词法单元返回false，type保持不变
+    bool map(tok_id_t &type, std::string_view value) const;
 };
 
 class TermTreeNode;
@@ -157,14 +240,12 @@ public:
         for_each(this->begin(), this->end(), nodeF);
     }
 
+    // 非递归的后序遍历，f(const tt_node_t &)
     template <typename func_t>
     void postorder(func_t f) const
     {
-        foreach (
-            [=](tt_node_t &ref)
-            { ref.postorder(f); })
-            ;
-        f(*this);
+        for (auto &node : walkPostorder(*this))
+            f(node);
     }
 
     std::string descData() const override
@@ -0,0 +1,90 @@
+/**
+ * @file gram/int/basic.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed Basic Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "basic.h"
+#include "utils/stl.h"
+#include "utils/log.h"
+#include "utils/table.h"
+
+#include <numeric>
+#include <algorithm>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+IntGrammar::IntGrammar(const Grammar &g)
+{
+    // 文法定义后又经过变换（如消除左递归）时，原有的符号表已过期，需要重新编号
+    bool stale = g.symtab.terminalCount() != g.terminals.size() || g.symtab.nonTermCount() != g.nonTerms.size();
+    symtab = stale ? SymbolInterner(g.terminals, g.nonTerms) : g.symtab;
+    symStart = symtab.id(g.symStart);
+    assert(symStart != SYM_NONE, "IntGrammar: Start symbol not interned.");
+    rules.resize(nonTermCount());
+    products.reserve(g.products.size());
+    for (auto &p : g.products)
+    {
+        int_product_t ip;
+        ip.left = symtab.id(p.first);
+        assert(
+            symtab.isNonTerm(ip.left),
+            format("IntGrammar: Unknown non-terminal $.", p.first));
+        ip.right.reserve(p.second.size());
+        for (auto &s : p.second)
+        {
+            sym_id_t id = symtab.id(s);
+            assert(id != SYM_NONE, format("IntGrammar: Unknown symbol $.", s));
+            ip.right.push_back(id);
+        }
+        rules[ntIndex(ip.left)].push_back(products.size());
+        products.push_back(move(ip));
+    }
+    // 按字符串版本中item_less的顺序为产生式排名
+    vector<size_t> order(products.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(
+        order.begin(), order.end(),
+        [&](size_t a, size_t b)
+        { return g.products[a] < g.products[b]; });
+    productRank.resize(products.size());
+    for (size_t i = 0; i < order.size(); i++)
+        productRank[order[i]] = i;
+    debug(0) << "IntGrammar: " << products.size() << " products converted." << endl;
+}
+
+string IntGrammar::product2str(size_t p) const
+{
+    string s = name(products[p].left) + "->";
+    for (size_t i = 0; i < products[p].right.size(); i++)
+    {
+        if (i)
+            s += " ";
+        s += name(products[p].right[i]);
+    }
+    return s;
+}
+
+string IntGrammar::bits2str(const Bitset &b) const
+{
+    symset_t names;
+    b.foreach ([&](size_t t)
+               { names.insert(name(t)); });
+    return set2str(names);
+}
+
+void IntGrammar::printRules() const
+{
+    using namespace table;
+    info << "IntGrammar: Rules:" << endl;
+    tb_head | "No." | "Product" = AL_LFT;
+    for (size_t i = 0; i < products.size(); i++)
+        new_row | to_string(i) | product2str(i);
+    cout << tb_view();
+}
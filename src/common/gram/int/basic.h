@@ -0,0 +1,74 @@
+/**
+ * @file gram/int/basic.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed Basic Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 以整数编号表示文法符号的文法
+ * 由Grammar及其符号表转换得到，产生式的顺序与Grammar::products一致
+ * 后续的First/Follow、LR项目集、分析表均在整数和位集合上计算，名称仅用于打印
+ */
+
+#pragma once
+
+#include "common/gram/basic.h"
+#include "utils/bitset.h"
+
+#include <vector>
+#include <string>
+
+using int_symstr_t = std::vector<sym_id_t>;
+
+struct int_product_t
+{
+    sym_id_t left;
+    int_symstr_t right;
+};
+
+class IntGrammar
+{
+public:
+    SymbolInterner symtab;
+    sym_id_t symStart = SYM_NONE;
+    std::vector<int_product_t> products;    // 与Grammar::products顺序一致
+    std::vector<std::vector<size_t>> rules; // 非终结符序号 -> 产生式下标
+    std::vector<size_t> productRank;        // 产生式在 (左部, 右部) 字典序下的名次，用于与字符串版本保持一致的遍历顺序
+
+    IntGrammar() = default;
+    IntGrammar(const Grammar &g);
+
+    size_t terminalCount() const
+    {
+        return symtab.terminalCount();
+    }
+    size_t nonTermCount() const
+    {
+        return symtab.nonTermCount();
+    }
+    // 非终结符编号 -> 非终结符序号（从0开始）
+    size_t ntIndex(sym_id_t v) const
+    {
+        return v - symtab.nonTermBase();
+    }
+    // 非终结符序号 -> 非终结符编号
+    sym_id_t ntSymbol(size_t i) const
+    {
+        return symtab.nonTermBase() + i;
+    }
+    bool isTerminal(sym_id_t s) const
+    {
+        return symtab.isTerminal(s);
+    }
+    const symbol_t &name(sym_id_t s) const
+    {
+        return symtab.name(s);
+    }
+    std::string product2str(size_t p) const;
+    std::string bits2str(const Bitset &b) const; // 以终结符名称打印位集合
+    void printRules() const;
+};
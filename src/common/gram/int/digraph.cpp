@@ -0,0 +1,78 @@
+/**
+ * @file gram/int/digraph.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Digraph Set Propagation
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "digraph.h"
+
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+void digraph(const relation_t &rel, vector<Bitset> &sets)
+{
+    const size_t INF = SIZE_MAX;
+    size_t n = rel.size();
+    vector<size_t> depth(n, 0); // 0表示未访问，INF表示所在分量已完成
+    vector<size_t> stk;         // Tarjan算法的结点栈
+    struct frame_t
+    {
+        size_t x, d, edge;
+    };
+    vector<frame_t> calls; // 以显式栈代替递归，避免深层文法导致栈溢出
+    for (size_t root = 0; root < n; root++)
+    {
+        if (depth[root] != 0)
+            continue;
+        stk.push_back(root);
+        depth[root] = stk.size();
+        calls.push_back({root, stk.size(), 0});
+        while (!calls.empty())
+        {
+            frame_t &f = calls.back();
+            size_t x = f.x;
+            if (f.edge < rel[x].size())
+            {
+                size_t y = rel[x][f.edge];
+                if (depth[y] == 0)
+                {
+                    stk.push_back(y);
+                    depth[y] = stk.size();
+                    calls.push_back({y, stk.size(), 0});
+                    continue;
+                }
+                depth[x] = min(depth[x], depth[y]);
+                sets[x] |= sets[y];
+                f.edge++;
+                continue;
+            }
+            // x的所有后继均已处理，x为分量的根时弹出整个分量
+            if (depth[x] == f.d)
+            {
+                while (true)
+                {
+                    size_t top = stk.back();
+                    stk.pop_back();
+                    depth[top] = INF;
+                    if (top == x)
+                        break;
+                    sets[top] = sets[x];
+                }
+            }
+            calls.pop_back();
+            if (!calls.empty())
+            {
+                frame_t &parent = calls.back();
+                depth[parent.x] = min(depth[parent.x], depth[x]);
+                sets[parent.x] |= sets[x];
+                parent.edge++;
+            }
+        }
+    }
+}
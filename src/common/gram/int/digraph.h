@@ -0,0 +1,27 @@
+/**
+ * @file gram/int/digraph.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Digraph Set Propagation
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include "utils/bitset.h"
+
+#include <vector>
+
+using relation_t = std::vector<std::vector<size_t>>;
+
+/**
+ * @brief DeRemer-Pennello的Digraph算法
+ * 对关系R和初始集合F'，求满足 F(x) = F'(x) ∪ ∪{F(y) | x R y} 的最小解
+ * 按Tarjan算法的顺序处理强连通分量：分量内各结点的集合相同，每条边只合并一次，无需迭代到不动点
+ *
+ * @param rel rel[x]为所有满足x R y的y
+ * @param sets 输入为F'，输出为F
+ */
+void digraph(const relation_t &rel, std::vector<Bitset> &sets);
@@ -0,0 +1,139 @@
+/**
+ * @file gram/int/lalr1.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed LALR(1) Lookaheads
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lalr1.h"
+#include "digraph.h"
+#include "utils/stl.h"
+#include "utils/log.h"
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+void IntLALR1Grammar::calcLookaheads()
+{
+    info << "IntLALR1Grammar: Calculating LALR(1) lookaheads..." << endl;
+    map<pair<state_id_t, sym_id_t>, size_t> transIndex;
+    for (auto &go : goTrans)
+    {
+        if (isTerminal(go.first.second))
+            continue;
+        transIndex[go.first] = ntTrans.size();
+        ntTrans.push_back(go.first);
+    }
+    size_t n = ntTrans.size();
+    // DR与reads
+    vector<Bitset> read(n, Bitset(terminalCount()));
+    relation_t reads(n);
+    for (size_t x = 0; x < n; x++)
+    {
+        state_id_t r = goTrans.at(ntTrans[x]);
+        for (auto it = goTrans.lower_bound(mkcrd(r, (sym_id_t)0)); it != goTrans.end() && it->first.first == r; it++)
+        {
+            sym_id_t C = it->first.second;
+            if (isTerminal(C))
+                read[x].set(C);
+            else if (nullable[ntIndex(C)])
+                reads[x].push_back(transIndex.at(it->first));
+        }
+    }
+    digraph(reads, read);
+    // 产生式prod的右部从状态p出发依次经过的状态，path[i]为读入right[i]之前的状态
+    auto path = [&](state_id_t p, size_t prod)
+    {
+        const int_symstr_t &right = products[prod].right;
+        vector<state_id_t> states = {p};
+        for (auto sym : right)
+            states.push_back(goTrans.at(mkcrd(states.back(), sym)));
+        return states;
+    };
+    // 对右部中其后缀可空的每个非终结符位置调用f(下标)
+    auto foreachNullableTail = [&](size_t prod, auto f)
+    {
+        const int_symstr_t &right = products[prod].right;
+        for (size_t i = right.size(); i-- > 0;)
+        {
+            if (isTerminal(right[i]))
+                break;
+            f(i);
+            if (!nullable[ntIndex(right[i])])
+                break;
+        }
+    };
+    // includes与lookback：从每个非终结符转移(p, A)出发，沿A的每个产生式的右部行进
+    relation_t includes(n);
+    vector<vector<pair<state_id_t, size_t>>> lookback(n); // 转移 -> 以其Follow为向前看的(状态, 产生式)
+    for (size_t x = 0; x < n; x++)
+    {
+        for (auto prod : rules[ntIndex(ntTrans[x].second)])
+        {
+            vector<state_id_t> states = path(ntTrans[x].first, prod);
+            const int_symstr_t &right = products[prod].right;
+            foreachNullableTail(prod, [&](size_t i)
+                                { includes[transIndex.at(mkcrd(states[i], right[i]))].push_back(x); });
+            lookback[x].push_back(make_pair(states.back(), prod));
+        }
+    }
+    // 开始符号的产生式没有对应的转移，其右部中后缀可空的转移直接以结束符号为Follow
+    sym_id_t symEnd = symtab.id(SYM_END);
+    for (auto prod : rules[ntIndex(symStart)])
+    {
+        vector<state_id_t> states = path(0, prod);
+        const int_symstr_t &right = products[prod].right;
+        foreachNullableTail(prod, [&](size_t i)
+                            { read[transIndex.at(mkcrd(states[i], right[i]))].set(symEnd); });
+    }
+    transFollow = read;
+    digraph(includes, transFollow);
+    for (size_t x = 0; x < n; x++)
+    {
+        for (auto &lb : lookback[x])
+        {
+            auto it = lookaheads.find(lb);
+            if (it == lookaheads.end())
+                it = lookaheads.emplace(lb, Bitset(terminalCount())).first;
+            it->second |= transFollow[x];
+        }
+    }
+    // 没有任何lookback的归约项目（如开始符号的产生式）向前看符号集为空
+    for (state_id_t s = 0; s < clusters.size(); s++)
+        for (auto item : clusters[s])
+            if (isComplete(item))
+                lookaheads.emplace(make_pair(s, itemProduct[item]), Bitset(terminalCount()));
+    debug(0) << "IntLALR1Grammar: " << n << " non-terminal transitions." << endl;
+}
+
+bool IntLALR1Grammar::checkLALR1() const
+{
+    info << "Checking LALR(1) grammar..." << endl;
+    bool flag = true;
+    for (state_id_t s = 0; s < clusters.size(); s++)
+    {
+        Bitset seen(terminalCount());
+        for (auto it = goTrans.lower_bound(mkcrd(s, (sym_id_t)0)); it != goTrans.end() && it->first.first == s; it++)
+            if (isTerminal(it->first.second))
+                seen.set(it->first.second);
+        for (auto item : clusters[s])
+        {
+            size_t p = itemProduct[item];
+            if (!isComplete(item) || products[p].left == symStart)
+                continue;
+            const Bitset &la = lookahead(s, p);
+            if (la.intersects(seen))
+            {
+                warn << "Conflict found in LALR(1) cluster " << s << " on " << product2str(p)
+                     << " with lookaheads " << bits2str(la) << "!" << endl;
+                flag = false;
+            }
+            seen |= la;
+        }
+    }
+    return flag;
+}
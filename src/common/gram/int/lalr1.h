@@ -0,0 +1,46 @@
+/**
+ * @file gram/int/lalr1.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed LALR(1) Lookaheads
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 以DeRemer-Pennello算法在LR(0)项目集规范族上计算LALR(1)向前看符号集
+ * 不构造LR(1)项目集，而是在非终结符转移(p, A)上定义三个关系：
+ * 1、DR(p, A)：goto(p, A)上可直接移进的终结符
+ * 2、reads：(p, A) reads (r, C)，当r = goto(p, A)且C可空
+ * 3、includes：(p, B) includes (p', A)，当A->βBγ，γ可空，且p'经β到达p
+ * Read = digraph(reads, DR)，Follow = digraph(includes, Read)，
+ * 归约项目A->ω在状态q的向前看符号集为所有满足p'经ω到达q的Follow(p', A)之并（lookback）
+ */
+
+#pragma once
+
+#include "lrg.h"
+
+#include <map>
+
+class IntLALR1Grammar : public IntLRGrammar
+{
+    void calcLookaheads();
+
+public:
+    std::vector<std::pair<state_id_t, sym_id_t>> ntTrans; // 非终结符转移的编号 -> (状态, 非终结符)
+    std::vector<Bitset> transFollow;                      // 非终结符转移的编号 -> Follow集
+    std::map<std::pair<state_id_t, size_t>, Bitset> lookaheads; // (状态, 产生式下标) -> 向前看符号集
+
+    IntLALR1Grammar() = default;
+    IntLALR1Grammar(const Grammar &g) : IntLRGrammar(g)
+    {
+        calcLookaheads();
+    }
+    const Bitset &lookahead(state_id_t s, size_t p) const
+    {
+        return lookaheads.at(std::make_pair(s, p));
+    }
+    bool checkLALR1() const;
+};
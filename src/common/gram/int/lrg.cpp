@@ -0,0 +1,146 @@
+/**
+ * @file gram/int/lrg.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed LR Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lrg.h"
+#include "utils/stl.h"
+#include "utils/log.h"
+#include "utils/table.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+using namespace table;
+
+#define DEBUG_LEVEL -1
+
+void IntLRGrammar::calcItems()
+{
+    info << "IntLRGrammar: Calculating LR items..." << endl;
+    itemBase.resize(products.size());
+    for (size_t p = 0; p < products.size(); p++)
+    {
+        itemBase[p] = itemProduct.size();
+        for (size_t i = 0; i <= products[p].right.size(); i++)
+        {
+            itemProduct.push_back(p);
+            itemDot.push_back(i);
+        }
+    }
+}
+
+void IntLRGrammar::calcClosure(int_cluster_t &c) const
+{
+    // 每个非终结符只展开一次，展开时加入其所有产生式的初始项目
+    Bitset expanded(nonTermCount());
+    for (size_t i = 0; i < c.size(); i++)
+    {
+        sym_id_t next = nextSymbol(c[i]);
+        if (next == SYM_NONE || isTerminal(next))
+            continue;
+        if (!expanded.insert(ntIndex(next)))
+            continue;
+        for (auto p : rules[ntIndex(next)])
+            c.push_back(itemBase[p]);
+    }
+    sort(c.begin(), c.end());
+    c.erase(unique(c.begin(), c.end()), c.end());
+}
+
+void IntLRGrammar::calcClusters()
+{
+    info << "IntLRGrammar: Calculating LR clusters..." << endl;
+    // 闭包除核心外只含初始项目，以核心项目为键去重，只为新状态计算闭包
+    unordered_map<int_cluster_t, state_id_t, vector_hash<item_id_t>> index;
+    int_cluster_t k0;
+    for (auto item : clusters[0])
+        if (itemDot[item] > 0 || products[itemProduct[item]].left == symStart)
+            k0.push_back(item);
+    index[k0] = 0;
+    // 与字符串版本一致：按广度优先的顺序编号，同一状态内先非终结符后终结符，各自按名称排序
+    auto symOrder = [&](sym_id_t a, sym_id_t b)
+    {
+        bool ta = isTerminal(a), tb = isTerminal(b);
+        return ta != tb ? tb : a < b;
+    };
+    for (state_id_t cIdx = 0; cIdx < clusters.size(); cIdx++)
+    {
+        map<sym_id_t, int_cluster_t, decltype(symOrder)> groups(symOrder);
+        for (auto item : clusters[cIdx])
+        {
+            sym_id_t next = nextSymbol(item);
+            if (next != SYM_NONE)
+                groups[next].push_back(item + 1);
+        }
+        for (auto &group : groups)
+        {
+            const int_cluster_t &kernel = group.second;
+            auto it = index.find(kernel);
+            state_id_t c1Idx;
+            if (it == index.end())
+            {
+                c1Idx = clusters.size();
+                index[kernel] = c1Idx;
+                int_cluster_t c1 = kernel;
+                calcClosure(c1);
+                clusters.push_back(c1);
+                debug(0) << "inserting cluster " << c1Idx << endl;
+            }
+            else
+            {
+                c1Idx = it->second;
+            }
+            goTrans[mkcrd(cIdx, group.first)] = c1Idx;
+        }
+    }
+}
+
+string IntLRGrammar::item2str(item_id_t item) const
+{
+    const int_product_t &p = products[itemProduct[item]];
+    size_t dot = itemDot[item];
+    string s = name(p.left) + "->";
+    for (size_t i = 0; i <= p.right.size(); i++)
+    {
+        if (i == dot)
+            s += ".";
+        if (i < p.right.size())
+            s += name(p.right[i]) + (i + 1 < p.right.size() && i + 1 != dot ? " " : "");
+    }
+    return s;
+}
+
+string IntLRGrammar::cluster2str(const int_cluster_t &c) const
+{
+    string s = "{";
+    for (size_t i = 0; i < c.size(); i++)
+    {
+        s += item2str(c[i]);
+        if (i != c.size() - 1)
+            s += ", ";
+    }
+    return s + "}";
+}
+
+void IntLRGrammar::printClusters() const
+{
+    info << "LR clusters:" << endl;
+    for (size_t i = 0; i < clusters.size(); i++)
+        info << "Cluster " << i << ": " << cluster2str(clusters[i]) << endl;
+}
+
+void IntLRGrammar::printGoTrans() const
+{
+    info << "LR go transitions:" << endl;
+    tb_head | "State" | "Symbol" | "Goto";
+    for (auto &go : goTrans)
+        new_row | "C" + to_string(go.first.first) | name(go.first.second) | "C" + to_string(go.second);
+    cout << tb_view(BDR_ALL);
+}
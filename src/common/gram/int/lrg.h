@@ -0,0 +1,67 @@
+/**
+ * @file gram/int/lrg.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed LR Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include "predict.h"
+#include "common/fa.h"
+
+#include <map>
+#include <vector>
+#include <string>
+
+/**
+ * LR(0)项目以整数编号表示：产生式p的第dot个项目编号为 itemBase[p] + dot
+ * 项目集（簇）为按编号升序排列的项目编号序列
+ */
+using item_id_t = uint32_t;
+using int_cluster_t = std::vector<item_id_t>;
+
+class IntLRGrammar : public IntPredictiveGrammar
+{
+protected:
+    void calcItems();
+    void calcClosure(int_cluster_t &c) const;
+    void calcClusters();
+
+public:
+    std::vector<item_id_t> itemBase; // 产生式下标 -> 该产生式第一个项目的编号
+    std::vector<size_t> itemProduct; // 项目编号 -> 产生式下标
+    std::vector<size_t> itemDot;     // 项目编号 -> 圆点位置
+    std::vector<int_cluster_t> clusters;
+    table_t<state_id_t, sym_id_t, state_id_t> goTrans;
+
+    IntLRGrammar() = default;
+    IntLRGrammar(const Grammar &g) : IntPredictiveGrammar(g)
+    {
+        calcItems();
+        int_cluster_t c0;
+        for (auto p : rules[ntIndex(symStart)])
+            c0.push_back(itemBase[p]);
+        calcClosure(c0);
+        clusters.push_back(c0);
+        calcClusters();
+    }
+    // 项目圆点后的符号，归约项目返回SYM_NONE
+    sym_id_t nextSymbol(item_id_t item) const
+    {
+        const int_symstr_t &right = products[itemProduct[item]].right;
+        size_t dot = itemDot[item];
+        return dot < right.size() ? right[dot] : SYM_NONE;
+    }
+    bool isComplete(item_id_t item) const
+    {
+        return nextSymbol(item) == SYM_NONE;
+    }
+    std::string item2str(item_id_t item) const;
+    std::string cluster2str(const int_cluster_t &c) const;
+    void printClusters() const;
+    void printGoTrans() const;
+};
@@ -0,0 +1,176 @@
+/**
+ * @file gram/int/predict.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed Predictive Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "predict.h"
+#include "digraph.h"
+#include "utils/stl.h"
+#include "utils/log.h"
+#include "utils/table.h"
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+bool IntPredictiveGrammar::firstOf(const int_symstr_t &s, size_t from, Bitset &res) const
+{
+    for (size_t i = from; i < s.size(); i++)
+    {
+        if (isTerminal(s[i]))
+        {
+            res.set(s[i]);
+            return false;
+        }
+        size_t v = ntIndex(s[i]);
+        res |= first[v];
+        if (!nullable[v])
+            return false;
+    }
+    return true;
+}
+
+void IntPredictiveGrammar::calcNullable()
+{
+    // 每个产生式记录右部中尚未确定可空的符号数，归零时左部可空，每个出现位置只处理一次
+    nullable.assign(nonTermCount(), false);
+    vector<size_t> remaining(products.size());
+    vector<vector<size_t>> occurs(nonTermCount()); // 非终结符序号 -> 所在的产生式（每次出现一项）
+    vector<size_t> queue;
+    for (size_t p = 0; p < products.size(); p++)
+    {
+        const int_symstr_t &right = products[p].right;
+        bool hasTerminal = false;
+        for (auto s : right)
+            hasTerminal = hasTerminal || isTerminal(s);
+        if (hasTerminal)
+            continue;
+        remaining[p] = right.size();
+        for (auto s : right)
+            occurs[ntIndex(s)].push_back(p);
+        if (remaining[p] == 0)
+            queue.push_back(p);
+    }
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        size_t A = ntIndex(products[queue[i]].left);
+        if (nullable[A])
+            continue;
+        nullable[A] = true;
+        for (auto p : occurs[A])
+            if (--remaining[p] == 0)
+                queue.push_back(p);
+    }
+}
+
+/**
+ * @brief 计算First集
+ * First(A)包含A的产生式中可空前缀之后的终结符，以及可空前缀之后的非终结符B的First(B)
+ * 后者构成非终结符之间的包含关系，由digraph按强连通分量一次求解
+ */
+void IntPredictiveGrammar::calcFirst()
+{
+    info << "IntPredictiveGrammar: Calculating First..." << endl;
+    calcNullable();
+    first.assign(nonTermCount(), Bitset(terminalCount()));
+    relation_t includes(nonTermCount());
+    for (auto &p : products)
+    {
+        size_t A = ntIndex(p.left);
+        for (auto s : p.right)
+        {
+            if (isTerminal(s))
+            {
+                first[A].set(s);
+                break;
+            }
+            includes[A].push_back(ntIndex(s));
+            if (!nullable[ntIndex(s)])
+                break;
+        }
+    }
+    digraph(includes, first);
+}
+
+/**
+ * @brief 计算Follow集
+ * 对A->αBβ，Follow(B)包含First(β)；若β可空，Follow(B)还包含Follow(A)
+ * 后者同样交由digraph按强连通分量求解
+ */
+void IntPredictiveGrammar::calcFollow()
+{
+    info << "IntPredictiveGrammar: Calculating Follow..." << endl;
+    follow.assign(nonTermCount(), Bitset(terminalCount()));
+    follow[ntIndex(symStart)].set(symtab.id(SYM_END));
+    relation_t includes(nonTermCount());
+    for (auto &p : products)
+    {
+        size_t A = ntIndex(p.left);
+        // 自右向左扫描，维护后缀β的First集及其是否可空
+        Bitset suffix(terminalCount());
+        bool eps = true;
+        for (size_t i = p.right.size(); i-- > 0;)
+        {
+            sym_id_t s = p.right[i];
+            if (isTerminal(s))
+            {
+                suffix.clear();
+                suffix.set(s);
+                eps = false;
+                continue;
+            }
+            size_t B = ntIndex(s);
+            follow[B] |= suffix;
+            if (eps && A != B)
+                includes[B].push_back(A);
+            if (!nullable[B])
+            {
+                suffix.clear();
+                eps = false;
+            }
+            suffix |= first[B];
+        }
+    }
+    digraph(includes, follow);
+}
+
+void IntPredictiveGrammar::calcSelect()
+{
+    info << "IntPredictiveGrammar: Calculating Select..." << endl;
+    select.assign(products.size(), Bitset(terminalCount()));
+    for (size_t i = 0; i < products.size(); i++)
+    {
+        if (firstOf(products[i].right, 0, select[i]))
+            select[i] |= follow[ntIndex(products[i].left)];
+    }
+}
+
+void IntPredictiveGrammar::printFirst() const
+{
+    info << "First:" << endl;
+    tb_head | "NonTerm" | "First" = table::AL_LFT;
+    for (size_t v = 0; v < nonTermCount(); v++)
+    {
+        symset_t names;
+        first[v].foreach ([&](size_t t)
+                          { names.insert(name(t)); });
+        if (nullable[v])
+            names.insert(EPSILON);
+        new_row | name(ntSymbol(v)) | set2str(names);
+    }
+    cout << tb_view();
+}
+
+void IntPredictiveGrammar::printFollow() const
+{
+    info << "Follow:" << endl;
+    tb_head | "NonTerm" | "Follow" = table::AL_LFT;
+    for (size_t v = 0; v < nonTermCount(); v++)
+        new_row | name(ntSymbol(v)) | bits2str(follow[v]);
+    cout << tb_view();
+}
@@ -0,0 +1,44 @@
+/**
+ * @file gram/int/predict.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed Predictive Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include "basic.h"
+
+/**
+ * @brief 以位集合表示First/Follow/Select集的预测文法
+ * 每个集合是以终结符编号为下标的位集合，空串单独以nullable标记
+ * First/Follow集按非终结符之间包含关系的强连通分量求解，不再反复迭代
+ */
+class IntPredictiveGrammar : public IntGrammar
+{
+protected:
+    void calcNullable();
+    void calcFirst();
+    void calcFollow();
+    void calcSelect();
+
+public:
+    std::vector<Bitset> first;  // 非终结符序号 -> First集（不含空串）
+    std::vector<bool> nullable; // 非终结符序号 -> 能否推导出空串
+    std::vector<Bitset> follow; // 非终结符序号 -> Follow集
+    std::vector<Bitset> select; // 产生式下标 -> Select集
+
+    IntPredictiveGrammar() = default;
+    IntPredictiveGrammar(const Grammar &g) : IntGrammar(g)
+    {
+        calcFirst();
+        calcFollow();
+        calcSelect();
+    }
+    bool firstOf(const int_symstr_t &s, size_t from, Bitset &res) const; // 将First(s[from:])并入res，返回该串能否推导出空串
+    void printFirst() const;
+    void printFollow() const;
+};
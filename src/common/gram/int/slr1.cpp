@@ -0,0 +1,83 @@
+/**
+ * @file gram/int/slr1.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed SLR(1) Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "slr1.h"
+#include "utils/stl.h"
+#include "utils/log.h"
+#include "utils/table.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace table;
+
+#define DEBUG_LEVEL -1
+
+void IntSLR1Grammar::calcSLR1Table()
+{
+    info << "IntSLR1Grammar: Calculating SLR(1) table..." << endl;
+    sym_id_t symEnd = symtab.id(SYM_END);
+    // 填入规约动作
+    // 与字符串版本一致，按项目的字典序填表，规约-规约冲突时后者覆盖前者
+    for (state_id_t i = 0; i < clusters.size(); i++)
+    {
+        vector<size_t> reduces;
+        for (auto item : clusters[i])
+            if (isComplete(item))
+                reduces.push_back(itemProduct[item]);
+        sort(
+            reduces.begin(), reduces.end(),
+            [&](size_t a, size_t b)
+            { return productRank[a] < productRank[b]; });
+        for (auto p : reduces)
+        {
+            sym_id_t left = products[p].left;
+            if (left == symStart)
+            {
+                slr1Table[mkcrd(i, symEnd)] = {ACT_ACCEPT, 0};
+                continue;
+            }
+            follow[ntIndex(left)].foreach ([&](size_t t)
+                                           { slr1Table[mkcrd(i, (sym_id_t)t)] = {ACT_REDUCE, (uint32_t)p}; });
+        }
+    }
+    // 填入移进动作，有冲突时移进优先
+    for (auto &go : goTrans)
+    {
+        if (_find(slr1Table, go.first))
+            warn << "Conflict found in SLR(1) table! Shift action will be applied!" << endl;
+        slr1Table[go.first] = {ACT_SHIFT, (uint32_t)go.second};
+    }
+}
+
+string IntSLR1Grammar::action2str(const int_action_t &a) const
+{
+    switch (a.kind)
+    {
+    case ACT_SHIFT:
+        return "S" + to_string(a.value);
+    case ACT_REDUCE:
+        return product2str(a.value);
+    case ACT_ACCEPT:
+        return "ACC";
+    default:
+        return "";
+    }
+}
+
+void IntSLR1Grammar::printSLR1TableOfState(state_id_t s) const
+{
+    info << "SLR1 table of state " << s << ":" << endl;
+    tb_head | "Symbol" | "Action/Goto" = AL_CTR;
+    tb_line();
+    for (sym_id_t a = 0; a < symtab.size(); a++)
+        new_row | name(a) | action2str(action(s, a));
+    cout << tb_view();
+}
@@ -0,0 +1,55 @@
+/**
+ * @file gram/int/slr1.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Integer-keyed SLR(1) Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include "lrg.h"
+
+#include <cstdint>
+
+enum int_action_kind_t : uint8_t
+{
+    ACT_ERROR,
+    ACT_SHIFT, // 对非终结符即为GOTO
+    ACT_REDUCE,
+    ACT_ACCEPT
+};
+
+struct int_action_t
+{
+    int_action_kind_t kind = ACT_ERROR;
+    uint32_t value = 0; // 移进/转移的目标状态，或规约的产生式下标
+
+    bool operator==(const int_action_t &a) const
+    {
+        return kind == a.kind && value == a.value;
+    }
+};
+
+class IntSLR1Grammar : public IntLRGrammar
+{
+    void calcSLR1Table();
+
+public:
+    table_t<state_id_t, sym_id_t, int_action_t> slr1Table;
+
+    IntSLR1Grammar() = default;
+    IntSLR1Grammar(const Grammar &g) : IntLRGrammar(g)
+    {
+        calcSLR1Table();
+    }
+    int_action_t action(state_id_t s, sym_id_t a) const
+    {
+        auto it = slr1Table.find(mkcrd(s, a));
+        return it == slr1Table.end() ? int_action_t() : it->second;
+    }
+    std::string action2str(const int_action_t &a) const;
+    void printSLR1TableOfState(state_id_t s) const;
+};
@@ -0,0 +1,57 @@
+/**
+ * @file gram/lalr1.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief LALR(1) Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lalr1.h"
+#include "utils/stl.h"
+
+#include <algorithm>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+symset_t LALR1Grammar::lookaheadOf(state_id_t s, size_t p) const
+{
+    symset_t res;
+    lalr.lookahead(s, p).foreach ([&](size_t t)
+                                  { res.insert(lalr.name(t)); });
+    return res;
+}
+
+void LALR1Grammar::calcLALR1Table()
+{
+    info << "Calculating LALR(1) table..." << endl;
+    assert(
+        lalr.clusters.size() == clusters.size(),
+        "LALR1Grammar: Cluster numbering mismatch.");
+    // 与SLR(1)一致，按项目的字典序填入规约动作，规约-规约冲突时后者覆盖前者
+    for (state_id_t i = 0; i < clusters.size(); i++)
+    {
+        vector<size_t> reduces;
+        for (auto item : lalr.clusters[i])
+            if (lalr.isComplete(item))
+                reduces.push_back(lalr.itemProduct[item]);
+        sort(
+            reduces.begin(), reduces.end(),
+            [&](size_t a, size_t b)
+            { return lalr.productRank[a] < lalr.productRank[b]; });
+        for (auto p : reduces)
+        {
+            if (products[p].first == symStart)
+            {
+                slr1Table[mkcrd(i, symbol_t(SYM_END))] = action_t(true);
+                continue;
+            }
+            lalr.lookahead(i, p).foreach ([&](size_t t)
+                                          { slr1Table[mkcrd(i, lalr.name(t))] = action_t(product_ref(products[p])); });
+        }
+    }
+    calcShiftActions();
+}
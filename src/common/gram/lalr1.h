@@ -0,0 +1,39 @@
+/**
+ * @file gram/lalr1.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief LALR(1) Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * LALR(1)文法
+ * 项目集规范族与SLR(1)相同，仅规约动作的向前看符号集由Follow集改为DeRemer-Pennello算法求得的LALR(1)向前看符号集
+ * 分析表沿用slr1Table的形式，因此可以直接交给紧凑分析表和各LR分析程序使用
+ */
+
+#pragma once
+
+#include "slr1.h"
+#include "int/lalr1.h"
+
+class LALR1Grammar : public SLR1Grammar
+{
+    IntLALR1Grammar lalr; // 在整数编号上求解的向前看符号集，状态编号与本文法一致
+    void calcLALR1Table();
+
+public:
+    LALR1Grammar() : SLR1Grammar(){};
+    LALR1Grammar(const Grammar &g, size_t threads = 1) : SLR1Grammar(g, threads, true), lalr(g)
+    {
+        calcLALR1Table();
+    }
+    LALR1Grammar(const LALR1Grammar &g) : SLR1Grammar(g), lalr(g.lalr) {}
+    symset_t lookaheadOf(state_id_t s, size_t p) const; // 状态s中按第p个产生式规约时的向前看符号集
+    bool checkLALR1() const
+    {
+        return lalr.checkLALR1();
+    }
+};
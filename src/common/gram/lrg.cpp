@@ -10,178 +10,534 @@
 
 #include "lrg.h"
 
-#include <queue>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
 
 using namespace std;
 using namespace table;
 
 #define DEBUG_LEVEL -1
 
-#define _isVT(t) _find(terminals, t)
-#define _isVN(t) _find(nonTerms, t)
+static const size_t NO_SYMBOL = SIZE_MAX;
 
-size_t intersects(const cluster_t &c1, const cluster_t &c2)
+void LRGrammar::calcItems()
 {
-    size_t cnt = 0;
-    for (auto &item : c1)
+    info << "Calculating LR items..." << endl;
+    // 符号序号的顺序即原有逐符号求后继状态的顺序，保证状态编号不变
+    unordered_map<symbol_t, size_t> symRank;
+    for (auto &v : nonTerms)
+    {
+        symRank[v] = rankSym.size();
+        rankSym.push_back(v);
+    }
+    for (auto &t : terminals)
+    {
+        symRank[t] = rankSym.size();
+        rankSym.push_back(t);
+    }
+    ntProducts.assign(nonTerms.size(), {});
+    for (size_t p = 0; p < products.size(); p++)
     {
-        if (c2.find(item) != c2.end())
+        product_t &prod = products[p];
+        itemBase.push_back(items.size());
+        ntProducts[symRank.at(prod.first)].push_back(p);
+        for (size_t i = 0; i <= prod.second.size(); i++)
         {
-            cnt++;
+            items.push_back(lr_item_t(prod, i));
+            // 既非终结符也非非终结符的符号（如空串）不产生转移
+            auto it = i < prod.second.size() ? symRank.find(prod.second[i]) : symRank.end();
+            itemNext.push_back(it == symRank.end() ? NO_SYMBOL : it->second);
         }
     }
-    return cnt;
 }
 
-int findInClusters(const clusters_t &clusters, const cluster_t &c)
+/**
+ * @brief 预先计算每个非终结符闭包中的全部初始项目
+ * 若A的某个产生式以非终结符B开头，则A的闭包包含B的闭包；
+ * 对非终结符之间的这一关系做一次传递闭包，再按可达关系合并各非终结符自身的初始项目
+ */
+void LRGrammar::calcNtClosure()
 {
-    for (size_t i = 0; i < clusters.size(); i++)
+    info << "Calculating LR closures of non-terminals..." << endl;
+    size_t n = nonTerms.size();
+    vector<Bitset> reach(n, Bitset(n));
+    vector<Bitset> init(n, Bitset(items.size()));
+    for (size_t v = 0; v < n; v++)
     {
-        if (clusters[i].size() != c.size())
-            continue;
-        if (intersects(clusters[i], c) == c.size())
-            return i;
+        reach[v].set(v);
+        for (auto p : ntProducts[v])
+        {
+            size_t item = itemBase[p];
+            init[v].set(item);
+            if (itemNext[item] < n)
+                reach[v].set(itemNext[item]);
+        }
     }
-    return -1;
+    for (size_t k = 0; k < n; k++)
+        for (size_t i = 0; i < n; i++)
+            if (reach[i].test(k))
+                reach[i] |= reach[k];
+    ntClosure.assign(n, Bitset(items.size()));
+    for (size_t v = 0; v < n; v++)
+        reach[v].foreach([&](size_t u)
+                         { ntClosure[v] |= init[u]; });
 }
 
-void LRGrammar::calcClosure(cluster_t &c)
+// 闭包即核心项目与其中各非终结符闭包的按位或
+item_ids_t LRGrammar::calcClosure(const item_ids_t &kernel) const
 {
     debug(0) << "Calculating LR closure..." << endl;
-    while (true)
+    Bitset c(items.size());
+    for (auto item : kernel)
     {
-        cluster_t c1;
-        for (auto &item : c)
-        {
-            symbol_t left = item.first.get().first;
-            symstr_t right = item.first.get().second;
-            size_t pos = item.second;
-            if (pos == right.size())
-                continue;
-            symbol_t next = right[pos];
-            if (_isVT(next))
-                continue;
-            for (auto &p : products)
-            {
-                if (p.first != next)
-                    continue;
-                lr_item_t item(p, 0);
-                debug(1) << "inserting " << item2str(item) << endl;
-                if (c.find(item) != c.end())
-                    continue;
-                c1.insert(item);
-            }
-        }
-        if (c1.size() == 0)
-            break;
-        c.insert(c1.begin(), c1.end());
+        c.set(item);
+        if (itemNext[item] < nonTerms.size())
+            c |= ntClosure[itemNext[item]];
     }
+    item_ids_t res;
+    c.foreach([&](size_t item)
+              { res.push_back(item); });
+    return res;
 }
 
+// 按圆点后的符号分组，得到各后继状态的核心项目；touched按符号序号升序列出非空的组
+void LRGrammar::calcSuccessors(const item_ids_t &closure, vector<item_ids_t> &groups, vector<size_t> &touched) const
+{
+    // 闭包按编号升序排列，分组后各组的核心项目同样有序
+    for (auto item : closure)
+    {
+        size_t next = itemNext[item];
+        if (next == NO_SYMBOL)
+            continue;
+        if (groups[next].empty())
+            touched.push_back(next);
+        groups[next].push_back(item + 1);
+    }
+    sort(touched.begin(), touched.end());
+}
+
+/**
+ * @brief 以工作表方式构造LR(0)项目集规范族
+ * 状态按广度优先的顺序编号，以核心项目的编号序列为键在哈希表中去重；
+ * 每个状态只扫描一遍其闭包，按圆点后的符号分组得到全部后继状态的核心项目
+ * 闭包除核心外只含初始项目，故核心相同与闭包相同等价，编号与逐符号、逐簇比较的实现一致
+ */
 void LRGrammar::calcClusters()
 {
     info << "Calculating LR clusters..." << endl;
-    queue<cluster_t> q;
-    q.push(clusters[0]);
-    while (!q.empty())
+    unordered_map<item_ids_t, state_id_t, vector_hash<size_t>> index;
+    vector<item_ids_t> closures;
+    item_ids_t k0;
+    for (size_t p = 0; p < products.size(); p++)
+        if (products[p].first == symStart)
+            k0.push_back(itemBase[p]);
+    index[k0] = 0;
+    closures.push_back(calcClosure(k0));
+    vector<item_ids_t> groups(rankSym.size());
+    vector<size_t> touched;
+    for (state_id_t cIdx = 0; cIdx < closures.size(); cIdx++)
     {
-        cluster_t c = q.front();
-        state_id_t cIdx = findInClusters(clusters, c);
-        q.pop();
-        for (auto &v : nonTerms)
+        calcSuccessors(closures[cIdx], groups, touched);
+        for (auto sym : touched)
         {
-            cluster_t c1;
-            for (auto &item : c)
-            {
-                symbol_t &left = item.first.get().first;
-                symstr_t &right = item.first.get().second;
-                size_t pos = item.second;
-                if (pos == right.size())
-                    continue;
-                symbol_t &next = right[pos];
-                if (next != v)
-                    continue;
-                lr_item_t item1(item.first, item.second + 1);
-                debug(0) << "inserting(nt) " << item2str(item1) << endl;
-                c1.insert(item1);
-            }
-            if (c1.size() == 0)
-                continue;
-            calcClosure(c1);
-            debug(0) << "new cluster(nt): " << cluster2str(c1) << endl;
-            int c1Idx = findInClusters(clusters, c1);
-            debug(0) << "cluster(nt) index: " << c1Idx << endl;
-            if (c1Idx == -1)
+            item_ids_t &kernel = groups[sym];
+            auto it = index.find(kernel);
+            state_id_t c1Idx;
+            if (it == index.end())
             {
-                c1Idx = clusters.size();
-                clusters.push_back(c1);
+                c1Idx = closures.size();
+                index.emplace(kernel, c1Idx);
+                closures.push_back(calcClosure(kernel));
                 debug(0) << "inserting cluster " << c1Idx << endl;
-                q.push(c1);
-            }
-            coord_t crd(cIdx, v);
-            if (_find(goTrans, crd))
-            {
-                assert(goTrans[crd] == c1Idx, "Unexpected go transition state.");
             }
             else
             {
-                goTrans[crd] = c1Idx;
+                c1Idx = it->second;
             }
+            goTrans[mkcrd(cIdx, rankSym[sym])] = c1Idx;
+            kernel.clear();
         }
-        for (auto &t : terminals)
+        touched.clear();
+    }
+    setClusters(closures);
+}
+
+/**
+ * @brief 多线程构造LR(0)项目集规范族
+ * 各线程从自己的双端队列尾部取出待扩展的状态，队列为空时从其他线程的队列头部窃取；
+ * 新的核心项目经分片加锁的哈希表去重并分配临时编号，闭包和后继由各线程独立计算
+ * 全部扩展完成后，从初始状态出发按广度优先、同一状态内按符号序号的顺序重新编号，结果与单线程构造完全一致
+ */
+void LRGrammar::calcClustersParallel(size_t threads)
+{
+    info << "Calculating LR clusters with " << threads << " threads..." << endl;
+    struct lr_work_t
+    {
+        size_t id;
+        item_ids_t kernel;
+    };
+    struct lr_state_t
+    {
+        item_ids_t closure;
+        vector<pair<size_t, size_t>> succ; // (符号序号, 后继的临时编号)，按符号序号升序
+    };
+    struct shard_t
+    {
+        mutex lock;
+        unordered_map<item_ids_t, size_t, vector_hash<size_t>> index;
+    };
+    struct work_queue_t
+    {
+        mutex lock;
+        deque<lr_work_t> works;
+    };
+    const size_t SHARDS = 64;
+    vector<shard_t> shards(SHARDS);
+    vector<work_queue_t> queues(threads);
+    vector<vector<pair<size_t, lr_state_t>>> results(threads);
+    atomic<size_t> nextId(1);
+    atomic<size_t> pending(1); // 已入队但尚未扩展完成的状态数
+    item_ids_t k0;
+    for (size_t p = 0; p < products.size(); p++)
+        if (products[p].first == symStart)
+            k0.push_back(itemBase[p]);
+    shards[vector_hash<size_t>()(k0) % SHARDS].index.emplace(k0, 0);
+    queues[0].works.push_back({0, k0});
+
+    auto worker = [&](size_t w)
+    {
+        vector<item_ids_t> groups(rankSym.size());
+        vector<size_t> touched;
+        while (true)
         {
-            cluster_t c1;
-            for (auto &item : c)
+            lr_work_t work;
+            bool got = false;
             {
-                symbol_t &left = item.first.get().first;
-                symstr_t &right = item.first.get().second;
-                size_t pos = item.second;
-                if (pos == right.size())
-                    continue;
-                symbol_t &next = right[pos];
-                if (next != t)
-                    continue;
-                lr_item_t item1(item.first, item.second + 1);
-                debug(0) << "inserting(t) " << item2str(item1) << endl;
-                c1.insert(item1);
+                lock_guard<mutex> guard(queues[w].lock);
+                if (!queues[w].works.empty())
+                {
+                    work = move(queues[w].works.back());
+                    queues[w].works.pop_back();
+                    got = true;
+                }
             }
-            if (c1.size() == 0)
-                continue;
-            calcClosure(c1);
-            debug(0) << "new cluster(t): " << cluster2str(c1) << endl;
-            int c1Idx = findInClusters(clusters, c1);
-            debug(0) << "cluster(t) index: " << c1Idx << endl;
-            if (c1Idx == -1)
+            for (size_t k = 1; !got && k < threads; k++)
             {
-                c1Idx = clusters.size();
-                clusters.push_back(c1);
-                debug(0) << "inserting cluster " << c1Idx << endl;
-                q.push(c1);
+                work_queue_t &victim = queues[(w + k) % threads];
+                lock_guard<mutex> guard(victim.lock);
+                if (!victim.works.empty())
+                {
+                    work = move(victim.works.front());
+                    victim.works.pop_front();
+                    got = true;
+                }
             }
-            coord_t crd(cIdx, t);
-            if (_find(goTrans, crd))
+            if (!got)
             {
-                assert(goTrans[crd] == c1Idx, "Unexpected go transition state.");
+                if (pending.load() == 0)
+                    return;
+                this_thread::yield();
+                continue;
             }
-            else
+            lr_state_t state;
+            state.closure = calcClosure(work.kernel);
+            calcSuccessors(state.closure, groups, touched);
+            for (auto sym : touched)
             {
-                goTrans[crd] = c1Idx;
+                item_ids_t &kernel = groups[sym];
+                shard_t &shard = shards[vector_hash<size_t>()(kernel) % SHARDS];
+                size_t id;
+                bool fresh = false;
+                {
+                    lock_guard<mutex> guard(shard.lock);
+                    auto it = shard.index.find(kernel);
+                    if (it == shard.index.end())
+                    {
+                        id = nextId++;
+                        shard.index.emplace(kernel, id);
+                        fresh = true;
+                    }
+                    else
+                    {
+                        id = it->second;
+                    }
+                }
+                if (fresh)
+                {
+                    pending++;
+                    lock_guard<mutex> guard(queues[w].lock);
+                    queues[w].works.push_back({id, move(kernel)});
+                }
+                state.succ.push_back(make_pair(sym, id));
+                kernel.clear();
             }
+            touched.clear();
+            results[w].emplace_back(work.id, move(state));
+            pending--;
+        }
+    };
+    vector<thread> pool;
+    for (size_t w = 1; w < threads; w++)
+        pool.emplace_back(worker, w);
+    worker(0);
+    for (auto &t : pool)
+        t.join();
+
+    // 规范化编号
+    vector<lr_state_t> states(nextId.load());
+    for (auto &res : results)
+        for (auto &r : res)
+            states[r.first] = move(r.second);
+    vector<size_t> canon(states.size(), SIZE_MAX);
+    vector<size_t> order = {0};
+    canon[0] = 0;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        for (auto &succ : states[order[i]].succ)
+        {
+            if (canon[succ.second] != SIZE_MAX)
+                continue;
+            canon[succ.second] = order.size();
+            order.push_back(succ.second);
         }
     }
+    vector<item_ids_t> closures;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        lr_state_t &state = states[order[i]];
+        closures.push_back(move(state.closure));
+        for (auto &succ : state.succ)
+            goTrans[mkcrd((state_id_t)i, rankSym[succ.first])] = canon[succ.second];
+    }
+    setClusters(closures);
 }
 
-void LRGrammar::calcItems()
+void LRGrammar::setClusters(const vector<item_ids_t> &closures)
 {
-    info << "Calculating LR items..." << endl;
-    for (auto &p : products)
+    for (auto &c : closures)
+    {
+        cluster_t cluster;
+        for (auto item : c)
+            cluster.insert(items[item]);
+        clusters.push_back(cluster);
+    }
+}
+
+// 产生式变化后重新为项目编号
+void LRGrammar::resetItems()
+{
+    items.clear();
+    itemBase.clear();
+    itemNext.clear();
+    rankSym.clear();
+    calcItems();
+    calcNtClosure();
+}
+
+// 产生式变化后完整地重新构造项目集规范族
+void LRGrammar::rebuildClusters()
+{
+    resetItems();
+    clusters.clear();
+    goTrans.clear();
+    if (buildThreads > 1)
+        calcClustersParallel(buildThreads);
+    else
+        calcClusters();
+}
+
+/**
+ * @brief 产生式变化后增量更新项目集规范族
+ * 调用前products已替换为新的产生式，clusters仍引用oldProducts中的旧产生式
+ * 闭包中既无左部、也无圆点后符号属于changed的状态不受影响，沿用原有的项目集和转移，只将其中的引用改为新的产生式；
+ * 其余状态按核心项目保留原编号并重新计算闭包和后继，新出现的状态追加在后，
+ * 最后删除从初始状态不可达的状态，其余状态保持原有的相对顺序
+ *
+ * @param oldProducts 旧的产生式
+ * @param prodMap 旧产生式下标到新下标的映射，被删除的产生式为SIZE_MAX
+ * @param changed 产生式发生变化的非终结符
+ * @param remap 输出旧状态编号到新编号的映射，被删除的状态为SIZE_MAX
+ * @return std::vector<bool> 新编号下各状态是否重新计算过
+ */
+vector<bool> LRGrammar::updateClusters(
+    const vector<product_t> &oldProducts, const vector<size_t> &prodMap,
+    const symset_t &changed, vector<size_t> &remap)
+{
+    info << "Updating LR clusters..." << endl;
+    resetItems();
+
+    // 旧状态按核心项目建立索引，受影响的状态重新计算闭包
+    size_t oldCount = clusters.size();
+    vector<item_ids_t> closures(oldCount);
+    vector<vector<pair<size_t, size_t>>> succ(oldCount); // 重新计算的状态 -> (符号序号, 后继)
+    vector<bool> redo(oldCount, false), lost(oldCount, false);
+    unordered_map<item_ids_t, size_t, vector_hash<size_t>> index;
+    for (size_t s = 0; s < oldCount; s++)
     {
-        for (size_t i = 0; i <= p.second.size(); i++)
+        item_ids_t kernel;
+        for (auto &item : clusters[s])
         {
-            lr_item_t item(p, i);
-            items.push_back(item);
+            const product_t &p = item.first.get();
+            size_t pos = item.second;
+            if (_find(changed, p.first) || (pos < p.second.size() && _find(changed, p.second[pos])))
+                redo[s] = true;
+            if (pos == 0)
+                continue;
+            size_t np = prodMap[&p - oldProducts.data()];
+            if (np == SIZE_MAX)
+                lost[s] = true;
+            else
+                kernel.push_back(itemBase[np] + pos);
+        }
+        // 初始状态的核心为开始符号的全部产生式，可能有新增的产生式
+        if (s == 0)
+            for (size_t p = 0; p < products.size(); p++)
+                if (products[p].first == symStart)
+                    kernel.push_back(itemBase[p]);
+        if (lost[s])
+            continue;
+        sort(kernel.begin(), kernel.end());
+        if (redo[s])
+            closures[s] = calcClosure(kernel);
+        index.emplace(move(kernel), s);
+    }
+
+    // 重新计算受影响状态的后继，新状态追加在后
+    vector<item_ids_t> groups(rankSym.size());
+    vector<size_t> touched;
+    for (size_t s = 0; s < closures.size(); s++)
+    {
+        if (!redo[s] || lost[s])
+            continue;
+        calcSuccessors(closures[s], groups, touched);
+        for (auto sym : touched)
+        {
+            item_ids_t &kernel = groups[sym];
+            auto it = index.find(kernel);
+            size_t target;
+            if (it == index.end())
+            {
+                target = closures.size();
+                closures.push_back(calcClosure(kernel));
+                succ.emplace_back();
+                redo.push_back(true);
+                lost.push_back(false);
+                index.emplace(kernel, target);
+            }
+            else
+            {
+                target = it->second;
+            }
+            succ[s].push_back(make_pair(sym, target));
+            kernel.clear();
         }
+        touched.clear();
     }
+
+    // 删除不可达的状态，其余状态保持相对顺序重新编号
+    // 未受影响的状态沿用goTrans中原有的转移
+    auto rowOf = [&](size_t s)
+    {
+        return goTrans.lower_bound(mkcrd((state_id_t)s, symbol_t()));
+    };
+    vector<bool> alive(closures.size(), false);
+    vector<size_t> stk = {0};
+    alive[0] = true;
+    auto visit = [&](size_t next)
+    {
+        if (!alive[next])
+        {
+            alive[next] = true;
+            stk.push_back(next);
+        }
+    };
+    while (!stk.empty())
+    {
+        size_t s = stk.back();
+        stk.pop_back();
+        if (redo[s])
+            for (auto &next : succ[s])
+                visit(next.second);
+        else
+            for (auto it = rowOf(s); it != goTrans.end() && it->first.first == s; it++)
+                visit(it->second);
+    }
+    vector<size_t> renum(closures.size(), SIZE_MAX);
+    size_t total = 0;
+    for (size_t s = 0; s < closures.size(); s++)
+        if (alive[s])
+            renum[s] = total++;
+    bool stable = count(alive.begin(), alive.begin() + oldCount, true) == oldCount;
+
+    // 未受影响的状态直接改写原有项目集中的产生式引用，项目的值不变，顺序也不变
+    clusters_t oldClusters;
+    oldClusters.swap(clusters);
+    vector<bool> res;
+    for (size_t s = 0; s < closures.size(); s++)
+    {
+        if (!alive[s])
+            continue;
+        res.push_back(redo[s]);
+        if (redo[s])
+        {
+            setClusters({closures[s]});
+            continue;
+        }
+        cluster_t &old = oldClusters[s], cluster;
+        while (!old.empty())
+        {
+            auto node = old.extract(old.begin());
+            node.value().first = products[prodMap[&node.value().first.get() - oldProducts.data()]];
+            cluster.insert(cluster.end(), move(node));
+        }
+        clusters.push_back(move(cluster));
+    }
+    // 没有状态被删除时编号不变，只替换重新计算的状态的转移；否则按新编号重建转移表
+    if (stable)
+    {
+        for (size_t s = 0; s < closures.size(); s++)
+        {
+            if (!redo[s])
+                continue;
+            auto it = rowOf(s);
+            while (it != goTrans.end() && it->first.first == s)
+                it = goTrans.erase(it);
+            for (auto &next : succ[s])
+                goTrans[mkcrd((state_id_t)s, rankSym[next.first])] = next.second;
+        }
+    }
+    else
+    {
+        table_t<state_id_t, symbol_t, state_id_t> oldTrans;
+        oldTrans.swap(goTrans);
+        for (size_t s = 0; s < closures.size(); s++)
+        {
+            if (!alive[s])
+                continue;
+            state_id_t from = renum[s];
+            if (redo[s])
+                for (auto &next : succ[s])
+                    goTrans[mkcrd(from, rankSym[next.first])] = renum[next.second];
+            else
+                for (auto it = oldTrans.lower_bound(mkcrd((state_id_t)s, symbol_t()));
+                     it != oldTrans.end() && it->first.first == s; it++)
+                    goTrans.emplace_hint(goTrans.end(), mkcrd(from, it->first.second), renum[it->second]);
+        }
+    }
+    remap.assign(renum.begin(), renum.begin() + oldCount);
+    info << "LR clusters updated: " << count(res.begin(), res.end(), true) << " of "
+         << clusters.size() << " states recalculated." << endl;
+    return res;
+}
+
+size_t LRGrammar::resolveThreads(size_t threads)
+{
+    return threads == 0 ? max(1u, thread::hardware_concurrency()) : threads;
 }
 
 void LRGrammar::printItems() const
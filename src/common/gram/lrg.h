@@ -14,6 +14,7 @@
 #include "utils/stl.h"
 #include "utils/log.h"
 #include "utils/table.h"
+#include "utils/bitset.h"
 #include "predict.h"
 
 #include <variant>
@@ -45,10 +46,10 @@ struct item_less
 {
     bool operator()(const lr_item_t &a, const lr_item_t &b) const
     {
-        symbol_t l1 = a.first.get().first;
+        const symbol_t &l1 = a.first.get().first;
         symstr_t &r1 = a.first.get().second;
         size_t p1 = a.second;
-        symbol_t l2 = b.first.get().first;
+        const symbol_t &l2 = b.first.get().first;
         symstr_t &r2 = b.first.get().second;
         size_t p2 = b.second;
         if (l1 != l2)
@@ -102,30 +103,49 @@ inline void printCluster(const cluster_t &c, int i = 0)
     std::cout << tb_view(BDR_RUD);
 }
 
+/**
+ * 构造项目集规范族时，项目以整数编号表示：产生式p的第dot个项目编号为 itemBase[p] + dot，
+ * 即items中的下标；状态以核心项目的编号序列去重，闭包和分组均在编号上进行，最后再转换为cluster_t
+ */
+using item_ids_t = std::vector<size_t>;
+
 class LRGrammar : public PredictiveGrammar
 {
+    std::vector<size_t> itemBase;                // 产生式下标 -> 该产生式第一个项目的编号
+    std::vector<size_t> itemNext;                // 项目编号 -> 圆点后符号的序号，归约项目为SIZE_MAX
+    std::vector<symbol_t> rankSym;               // 符号序号 -> 符号，非终结符在前、终结符在后，各自按名称排序
+    std::vector<std::vector<size_t>> ntProducts; // 非终结符序号 -> 以其为左部的产生式下标
+    std::vector<Bitset> ntClosure;               // 非终结符序号 -> 其闭包中的全部初始项目
+    size_t buildThreads = 1;                     // 构造项目集规范族的线程数，不大于1时单线程构造
     void calcItems();
-    void calcClosure(cluster_t &c);
+    void calcNtClosure();
+    item_ids_t calcClosure(const item_ids_t &kernel) const;
+    void calcSuccessors(const item_ids_t &closure, std::vector<item_ids_t> &groups, std::vector<size_t> &touched) const;
     void calcClusters();
+    void calcClustersParallel(size_t threads);
+    void setClusters(const std::vector<item_ids_t> &closures);
+    void resetItems();
+    static size_t resolveThreads(size_t threads);
+
+protected:
+    void rebuildClusters();
+    std::vector<bool> updateClusters(
+        const std::vector<product_t> &oldProducts, const std::vector<size_t> &prodMap,
+        const symset_t &changed, std::vector<size_t> &remap);
 
 public:
     LRGrammar() : PredictiveGrammar(){};
-    LRGrammar(const Grammar &g) : PredictiveGrammar(g)
+    // threads为构造项目集规范族的线程数，0表示使用全部硬件线程；状态编号与单线程构造一致
+    LRGrammar(const Grammar &g, size_t threads = 1) : PredictiveGrammar(g), buildThreads(resolveThreads(threads))
     {
         calcItems();
-        cluster_t c0;
-        for (auto &p : products)
-        {
-            if (p.first != symStart)
-                continue;
-            lr_item_t item(p, 0);
-            c0.insert(item);
-        }
-        calcClosure(c0);
-        clusters.push_back(c0);
-        calcClusters();
+        calcNtClosure();
+        if (buildThreads > 1)
+            calcClustersParallel(buildThreads);
+        else
+            calcClusters();
     }
-    LRGrammar(const LRGrammar &g) : PredictiveGrammar(g)
+    LRGrammar(const LRGrammar &g) : PredictiveGrammar(g), buildThreads(g.buildThreads)
     {
         items = g.items;
         clusters = g.clusters;
@@ -0,0 +1,231 @@
+/**
+ * @file gram/lrtbl.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Packed LR Parsing Table
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lrtbl.h"
+#include "utils/log.h"
+
+#include <map>
+#include <algorithm>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+PackedLRTable::PackedLRTable(const SLR1Grammar &g)
+{
+    info << "PackedLRTable: Freezing SLR(1) table..." << endl;
+    symtab = g.symtab.empty() ? SymbolInterner(g.terminals, g.nonTerms) : g.symtab;
+    stateCount = g.clusters.size();
+    termCount = symtab.terminalCount();
+    nonTermCount = symtab.nonTermCount();
+    actionTbl.assign(stateCount * termCount, lrPack(LR_ERROR));
+    gotoTbl.assign(stateCount * nonTermCount, lrPack(LR_ERROR));
+    // 规约动作中的产生式引用不一定指向g.products本身（文法对象可能被拷贝过），因此按值查找下标
+    map<product_t, size_t> productIdx;
+    for (size_t p = 0; p < g.products.size(); p++)
+    {
+        productIdx.insert(make_pair(g.products[p], p));
+        reduceLen.push_back(g.products[p].second.size());
+        reduceLeft.push_back(symtab.id(g.products[p].first));
+    }
+    for (auto &entry : g.slr1Table)
+    {
+        state_id_t s = entry.first.first;
+        sym_id_t a = symtab.id(entry.first.second);
+        if (a == SYM_NONE)
+            continue;
+        const action_t &act = entry.second;
+        lr_entry_t e;
+        if (holds_alternative<shift_t>(act))
+            e = lrPack(LR_SHIFT, get<shift_t>(act));
+        else if (holds_alternative<reduce_t>(act))
+            e = lrPack(LR_REDUCE, productIdx.at(get<reduce_t>(act).get()));
+        else if (get<accept_t>(act))
+            e = lrPack(LR_ACCEPT);
+        else
+            continue; // 缺省构造的表项，视为错误
+        if (symtab.isTerminal(a))
+            actionTbl[s * termCount + a] = e;
+        else
+            gotoTbl[s * nonTermCount + (a - termCount)] = e;
+    }
+    info << "PackedLRTable: " << stateCount << " states, " << bytes() << " bytes." << endl;
+}
+
+using comb_row_t = vector<pair<uint32_t, lr_entry_t>>;
+
+/**
+ * @brief 以首次适配的方式将若干稀疏行交错放入梳状向量
+ * 表项多的行先放置，每行选择使其所有表项都落在空闲位置的最小位移
+ *
+ * @param rows 各行的非缺省表项（列号, 表项）
+ * @param width 行宽，梳状向量末尾补齐width个位置，保证任意列的查表不越界
+ * @param base 输出各行的位移
+ * @param next 输出梳状向量
+ * @param check 输出各位置所属的行号
+ */
+static void packComb(
+    const vector<comb_row_t> &rows, size_t width,
+    vector<uint32_t> &base, vector<lr_entry_t> &next, vector<uint32_t> &check,
+    uint32_t noOwner)
+{
+    vector<size_t> order(rows.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    stable_sort(
+        order.begin(), order.end(),
+        [&](size_t a, size_t b)
+        { return rows[a].size() > rows[b].size(); });
+    base.assign(rows.size(), 0);
+    vector<bool> used;
+    size_t firstFree = 0;
+    for (auto r : order)
+    {
+        const comb_row_t &row = rows[r];
+        if (row.empty())
+            continue;
+        while (firstFree < used.size() && used[firstFree])
+            firstFree++;
+        // 位移从使第一个表项落在第一个空闲位置处开始尝试
+        size_t b = firstFree > row[0].first ? firstFree - row[0].first : 0;
+        while (true)
+        {
+            bool fit = true;
+            for (auto &e : row)
+            {
+                size_t pos = b + e.first;
+                if (pos < used.size() && used[pos])
+                {
+                    fit = false;
+                    break;
+                }
+            }
+            if (fit)
+                break;
+            b++;
+        }
+        base[r] = b;
+        for (auto &e : row)
+        {
+            size_t pos = b + e.first;
+            if (pos >= used.size())
+            {
+                used.resize(pos + 1, false);
+                next.resize(pos + 1, lrPack(LR_ERROR));
+                check.resize(pos + 1, noOwner);
+            }
+            used[pos] = true;
+            next[pos] = e.second;
+            check[pos] = r;
+        }
+    }
+    size_t maxBase = 0;
+    for (auto b : base)
+        maxBase = max<size_t>(maxBase, b);
+    next.resize(maxBase + width, lrPack(LR_ERROR));
+    check.resize(maxBase + width, noOwner);
+}
+
+/**
+ * @brief 取出一行中出现最多的表项作为缺省值，并从行中删除
+ *
+ * @param row 非错误表项
+ * @param onlyReduce 是否只允许规约动作作为缺省值（ACTION表）
+ * @return lr_entry_t 缺省值，没有合适的表项时为错误
+ */
+static lr_entry_t extractDefault(comb_row_t &row, bool onlyReduce)
+{
+    map<lr_entry_t, size_t> freq;
+    for (auto &e : row)
+        if (!onlyReduce || lrKind(e.second) == LR_REDUCE)
+            freq[e.second]++;
+    lr_entry_t def = lrPack(LR_ERROR);
+    size_t best = 0;
+    for (auto &f : freq)
+    {
+        if (f.second > best)
+        {
+            best = f.second;
+            def = f.first;
+        }
+    }
+    if (best == 0)
+        return def;
+    row.erase(
+        remove_if(
+            row.begin(), row.end(),
+            [&](const pair<uint32_t, lr_entry_t> &e)
+            { return e.second == def; }),
+        row.end());
+    return def;
+}
+
+CombLRTable::CombLRTable(const PackedLRTable &t)
+{
+    info << "CombLRTable: Compressing LR table..." << endl;
+    symtab = t.symtab;
+    stateCount = t.stateCount;
+    termCount = t.termCount;
+    reduceLen = t.reduceLen;
+    reduceLeft = t.reduceLeft;
+    // ACTION表：去除缺省规约后合并相同的行
+    map<pair<comb_row_t, lr_entry_t>, uint32_t> rowIndex;
+    vector<comb_row_t> rows;
+    actionRow.resize(stateCount);
+    for (size_t s = 0; s < stateCount; s++)
+    {
+        comb_row_t row;
+        for (size_t a = 0; a < termCount; a++)
+        {
+            lr_entry_t e = t.actionTbl[s * termCount + a];
+            if (lrKind(e) != LR_ERROR)
+                row.push_back(make_pair(a, e));
+        }
+        lr_entry_t def = extractDefault(row, true);
+        auto key = make_pair(row, def);
+        auto it = rowIndex.find(key);
+        if (it == rowIndex.end())
+        {
+            it = rowIndex.insert(make_pair(key, (uint32_t)rows.size())).first;
+            rows.push_back(row);
+            actionDef.push_back(def);
+        }
+        actionRow[s] = it->second;
+    }
+    packComb(rows, termCount, actionBase, actionNext, actionCheck, NO_OWNER);
+    // GOTO表：按列压缩，缺省值为该列最常见的目标状态
+    vector<comb_row_t> cols(t.nonTermCount);
+    for (size_t v = 0; v < t.nonTermCount; v++)
+    {
+        for (size_t s = 0; s < stateCount; s++)
+        {
+            lr_entry_t e = t.gotoTbl[s * t.nonTermCount + v];
+            if (lrKind(e) != LR_ERROR)
+                cols[v].push_back(make_pair(s, e));
+        }
+        gotoDef.push_back(extractDefault(cols[v], false));
+    }
+    packComb(cols, stateCount, gotoBase, gotoNext, gotoCheck, NO_OWNER);
+    info << "CombLRTable: " << stateCount << " states merged into " << rows.size()
+         << " rows, " << bytes() << " bytes (packed: " << t.bytes() << " bytes)." << endl;
+}
+
+size_t CombLRTable::bytes() const
+{
+    return actionRow.size() * sizeof(uint32_t) +
+           actionBase.size() * sizeof(uint32_t) +
+           actionDef.size() * sizeof(lr_entry_t) +
+           actionNext.size() * sizeof(lr_entry_t) +
+           actionCheck.size() * sizeof(uint32_t) +
+           gotoBase.size() * sizeof(uint32_t) +
+           gotoDef.size() * sizeof(lr_entry_t) +
+           gotoNext.size() * sizeof(lr_entry_t) +
+           gotoCheck.size() * sizeof(uint32_t);
+}
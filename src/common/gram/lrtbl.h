@@ -0,0 +1,172 @@
+/**
+ * @file gram/lrtbl.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Packed LR Parsing Table
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 将SLR1Grammar::slr1Table冻结为连续存储的ACTION表和GOTO表
+ * 每个表项为一个32位整数，高2位为动作类型，低30位为目标状态或产生式下标
+ * 两张表均按行优先存储，行为状态，列为符号编号（见SymbolInterner）
+ * 查表只需一次乘加和一次访存，不做字符串比较，也不会插入缺省表项
+ *
+ * 对于状态数较多的文法，CombLRTable进一步将其压缩为行位移（梳状向量）格式：
+ * 1、每个状态取出现最多的规约动作作为缺省规约，不再显式存储
+ * 2、内容相同的行合并为一行
+ * 3、各行的非缺省表项以不同的位移量交错放入同一个一维数组，以check数组区分归属
+ * GOTO表按列（非终结符）做同样的处理，缺省值为该列最常见的目标状态
+ * 查表仍为常数时间，与PackedLRTable提供相同的接口，可直接用于driveLR
+ */
+
+#pragma once
+
+#include "slr1.h"
+
+#include <vector>
+#include <cstdint>
+
+using lr_entry_t = uint32_t;
+
+enum lr_kind_t : uint32_t
+{
+    LR_ERROR = 0u << 30,
+    LR_SHIFT = 1u << 30, // 对非终结符即为GOTO
+    LR_REDUCE = 2u << 30,
+    LR_ACCEPT = 3u << 30
+};
+
+constexpr lr_entry_t LR_KIND_MASK = 3u << 30;
+constexpr lr_entry_t LR_VALUE_MASK = ~LR_KIND_MASK;
+
+constexpr lr_entry_t lrPack(lr_kind_t kind, uint32_t value = 0)
+{
+    return kind | (value & LR_VALUE_MASK);
+}
+
+constexpr lr_kind_t lrKind(lr_entry_t e)
+{
+    return (lr_kind_t)(e & LR_KIND_MASK);
+}
+
+constexpr uint32_t lrValue(lr_entry_t e)
+{
+    return e & LR_VALUE_MASK;
+}
+
+class PackedLRTable
+{
+    friend class CombLRTable;
+
+    size_t stateCount = 0;
+    size_t termCount = 0;
+    size_t nonTermCount = 0;
+    std::vector<lr_entry_t> actionTbl; // [state * termCount + terminal]
+    std::vector<lr_entry_t> gotoTbl;   // [state * nonTermCount + (nonTerm - termCount)]
+    std::vector<uint32_t> reduceLen;   // 产生式下标 -> 右部长度
+    std::vector<sym_id_t> reduceLeft;  // 产生式下标 -> 左部符号编号
+
+public:
+    SymbolInterner symtab; // 列编号所用的符号表
+
+    PackedLRTable() = default;
+    PackedLRTable(const SLR1Grammar &g);
+    // 由已冻结的表直接构造（如从预编译文件中加载）
+    PackedLRTable(
+        const SymbolInterner &symtab, size_t stateCount,
+        std::vector<lr_entry_t> actionTbl, std::vector<lr_entry_t> gotoTbl,
+        std::vector<uint32_t> reduceLen, std::vector<sym_id_t> reduceLeft)
+        : stateCount(stateCount), termCount(symtab.terminalCount()), nonTermCount(symtab.nonTermCount()),
+          actionTbl(std::move(actionTbl)), gotoTbl(std::move(gotoTbl)),
+          reduceLen(std::move(reduceLen)), reduceLeft(std::move(reduceLeft)), symtab(symtab) {}
+
+    lr_entry_t action(state_id_t s, sym_id_t t) const
+    {
+        return t < termCount ? actionTbl[s * termCount + t] : lrPack(LR_ERROR);
+    }
+    lr_entry_t go(state_id_t s, sym_id_t v) const
+    {
+        return gotoTbl[s * nonTermCount + (v - termCount)];
+    }
+    uint32_t productLength(size_t p) const
+    {
+        return reduceLen[p];
+    }
+    sym_id_t productLeft(size_t p) const
+    {
+        return reduceLeft[p];
+    }
+    size_t size() const
+    {
+        return stateCount;
+    }
+    size_t bytes() const
+    {
+        return (actionTbl.size() + gotoTbl.size()) * sizeof(lr_entry_t);
+    }
+    const std::vector<lr_entry_t> &getActionTable() const
+    {
+        return actionTbl;
+    }
+    const std::vector<lr_entry_t> &getGotoTable() const
+    {
+        return gotoTbl;
+    }
+};
+
+class CombLRTable
+{
+    static constexpr uint32_t NO_OWNER = UINT32_MAX;
+
+    size_t stateCount = 0;
+    size_t termCount = 0;
+    std::vector<uint32_t> actionRow;    // 状态 -> 合并后的行号
+    std::vector<uint32_t> actionBase;   // 行号 -> 在actionNext中的位移
+    std::vector<lr_entry_t> actionDef;  // 行号 -> 缺省动作（缺省规约或错误）
+    std::vector<lr_entry_t> actionNext; // 梳状向量
+    std::vector<uint32_t> actionCheck;  // 梳状向量中各位置所属的行号
+    std::vector<uint32_t> gotoBase;     // 非终结符序号 -> 在gotoNext中的位移
+    std::vector<lr_entry_t> gotoDef;    // 非终结符序号 -> 缺省目标
+    std::vector<lr_entry_t> gotoNext;   // 梳状向量
+    std::vector<uint32_t> gotoCheck;    // 梳状向量中各位置所属的非终结符序号
+    std::vector<uint32_t> reduceLen;    // 产生式下标 -> 右部长度
+    std::vector<sym_id_t> reduceLeft;   // 产生式下标 -> 左部符号编号
+
+public:
+    SymbolInterner symtab;
+
+    CombLRTable() = default;
+    CombLRTable(const PackedLRTable &t);
+    CombLRTable(const SLR1Grammar &g) : CombLRTable(PackedLRTable(g)) {}
+
+    lr_entry_t action(state_id_t s, sym_id_t t) const
+    {
+        if (t >= termCount)
+            return lrPack(LR_ERROR);
+        uint32_t r = actionRow[s];
+        size_t idx = actionBase[r] + t;
+        return actionCheck[idx] == r ? actionNext[idx] : actionDef[r];
+    }
+    lr_entry_t go(state_id_t s, sym_id_t v) const
+    {
+        uint32_t c = v - termCount;
+        size_t idx = gotoBase[c] + s;
+        return gotoCheck[idx] == c ? gotoNext[idx] : gotoDef[c];
+    }
+    uint32_t productLength(size_t p) const
+    {
+        return reduceLen[p];
+    }
+    sym_id_t productLeft(size_t p) const
+    {
+        return reduceLeft[p];
+    }
+    size_t size() const
+    {
+        return stateCount;
+    }
+    size_t bytes() const;
+};
@@ -12,17 +12,11 @@
 #include "utils/log.h"
 #include "utils/table.h"
 #include "predict.h"
+#include "int/predict.h"
 
 using namespace std;
 
-#define DEBUG_LEVEL 0
-
-#define insert_if_not_exist(A, s)               \
-    {                                           \
-        flag = false;                           \
-        tie(ignore, flag) = first[A].insert(s); \
-        changed = changed || flag;              \
-    }
+#define DEBUG_LEVEL -1
 
 bool PredictiveGrammar::isLL1Grammar() const // 判断是否为LL(1)文法
 {
@@ -79,308 +73,44 @@ bool PredictiveGrammar::isLL1Grammar() const // 判断是否为LL(1)文法
     return true;
 }
 
-symset_t PredictiveGrammar::calcFirstOf(symbol_t t)
-{
-    debug(0) << "Calculating First(" << t << ")" << endl;
-    if (hasLeftRecursion)
-    {
-        return first[t];
-    }
-    if (first[t].size() > 0)
-    {
-        debug(1) << "First(" << t << ") has been calculated before" << endl;
-        return first[t]; // 已经计算过
-    }
-    // 对于每个产生式，计算first集
-    for (auto &right : rules[t])
-    {
-        // 空产生式，加入epsilon
-        if (right.size() == 0)
-        {
-            first[t].insert(EPSILON);
-            debug(1) << "First(" << t << ") <- {epsilon}" << endl;
-        }
-        else
-        {
-            // 对于产生式右部的每个符号
-            bool allHaveEpsilon = true;
-            for (auto it = right.begin(); it != right.end(); it++)
-            {
-                if (_find(terminals, *it))
-                {
-                    // 终结符，直接加入first集
-                    first[t].insert(*it);
-                    debug(1) << "First(" << t << ") <- {" << *it << "}" << endl;
-                    allHaveEpsilon = false;
-                    break; // 终结符后面的符号不再计算
-                }
-                else
-                {
-                    if (it == right.begin() && *it == t)
-                    {
-                        // 直接左递归
-                        warn << "Direct left recursion detected. Trying to calculate First with Left Recursion..." << endl;
-                        hasLeftRecursion = true;
-                        calcFirstWithLeftRecursion();
-                        return first[t];
-                    }
-                    symset_t resFirst = calcFirstOf(*it);
-                    symset_t tmpFirst = resFirst;
-                    tmpFirst.erase(EPSILON);
-                    first[t].insert(tmpFirst.begin(), tmpFirst.end());
-                    for (auto &f : tmpFirst)
-                    {
-                        debug(1) << "First(" << t << ") <- {" << f << "}" << endl;
-                    }
-                    if (!_find(resFirst, EPSILON))
-                    {
-                        // 该符号的first集不含epsilon，后面的符号不再计算
-                        allHaveEpsilon = false;
-                        break;
-                    }
-                }
-            }
-            if (allHaveEpsilon)
-            {
-                first[t].insert(EPSILON);
-                debug(1) << "First(" << t << ") <- {epsilon}" << endl;
-            }
-        }
-    }
-    return first[t];
-}
-
-symset_t PredictiveGrammar::calcFirstOf(symstr_t s)
-{
-    debug(0) << format("Calculating First($)", vec2str(s)) << endl;
-    if (firstS[s].size() > 0)
-    {
-        debug(1) << format(
-            "First($) has been calculated before.\n",
-            vec2str(s));
-        return firstS[s]; // 已经计算过
-    }
-    symset_t resFirst;
-    bool allHaveEpsilon = true;
-    for (auto &symbol : s)
-    {
-        if (_find(terminals, symbol))
-        {
-            // 终结符，直接加入first集
-            resFirst.insert(symbol);
-            debug(1) << "First(" << vec2str(s) << ") <- {" << symbol << "}" << endl;
-            allHaveEpsilon = false;
-            break; // 终结符后面的符号不再计算
-        }
-        else
-        {
-            symset_t tmpFirst = calcFirstOf(symbol);
-            resFirst.insert(tmpFirst.begin(), tmpFirst.end());
-            debug(1) << "First(" << vec2str(s) << ") <- " << set2str(tmpFirst) << endl;
-            if (!_find(tmpFirst, EPSILON))
-            {
-                // 该符号的first集不含epsilon，后面的符号不再计算
-                allHaveEpsilon = false;
-                break;
-            }
-        }
-    }
-    if (allHaveEpsilon)
-    {
-        resFirst.insert(EPSILON);
-        debug(1) << "First(" << vec2str(s) << ") <- { epsilon }" << endl;
-    }
-    firstS[s] = resFirst;
-    return resFirst;
-}
-
-symset_t PredictiveGrammar::calcFollowOf(symbol_t t)
-{
-    debug(0) << "Calculating Follow(" << t << ")" << endl;
-    if (follow[t].size() > 0)
-    {
-        debug(1) << "Follow(" << t << ") has been calculated before" << endl;
-        return follow[t]; // 已经计算过
-    }
-    if (t == symStart)
-    {
-        follow[t].insert(SYM_END);
-        debug(1) << "Follow(" << t << ") <- {#}" << endl;
-    }
-    for (auto &rule : rules)
-    {
-        for (auto &right : rule.second)
-        {
-            auto symIt = right.begin();
-            symIt = find(symIt, right.end(), t);
-            while (symIt != right.end())
-            {
-                if (symIt == right.end() - 1)
-                {
-                    // A -> aB
-                    if (rule.first != t)
-                    {
-                        symset_t resFollow = calcFollowOf(rule.first);
-                        follow[t].insert(resFollow.begin(), resFollow.end());
-                        for (auto &f : resFollow)
-                        {
-                            debug(1) << "Follow(" << t << ") <-> {" << f << "} <A -> aB>" << endl;
-                        }
-                    }
-                }
-                else if (_find(terminals, *(symIt + 1)))
-                {
-                    // A -> aBb
-                    follow[t].insert(*(symIt + 1));
-                    debug(1) << "Follow(" << t << ") <- {" << *(symIt + 1) << "} <A -> aBb>" << endl;
-                }
-                else
-                {
-                    // A -> aBC
-                    symset_t resFirst;
-                    for (auto tmpIt = symIt + 1; tmpIt != right.end(); tmpIt++)
-                    {
-                        resFirst = calcFirstOf(*tmpIt);
-                        symset_t tmpFirst = resFirst;
-                        tmpFirst.erase(EPSILON);
-                        follow[t].insert(tmpFirst.begin(), tmpFirst.end());
-                        for (auto &f : tmpFirst)
-                        {
-                            debug(1) << "Follow(" << t << ") = {" << f << "} <A -> aBC>" << endl;
-                        }
-                        if (!_find(resFirst, EPSILON))
-                        {
-                            break;
-                        }
-                    }
-                    if (resFirst.size() == 0 || _find(resFirst, EPSILON))
-                    {
-                        // A -> aBC, First(C) 含有epsilon
-                        if (rule.first != t)
-                        {
-                            symset_t resFollow = calcFollowOf(rule.first);
-                            follow[t].insert(resFollow.begin(), resFollow.end());
-                            for (auto &f : resFollow)
-                            {
-                                debug(1) << "Follow(" << t << ") = {" << f << "} <A -> aBC(e)>" << endl;
-                            }
-                        }
-                    }
-                }
-                symIt = find(symIt + 1, right.end(), t);
-            }
-        }
-    }
-    return follow[t];
-}
-
-symset_t PredictiveGrammar::calcSelectOf(product_t p)
-{
-    debug(0) << "Calculating Select(" << p.first;
-    debug_u(0) << " -> " << vec2str(p.second) << ")" << endl;
-    symset_t resSelect;
-    symset_t resFirst = firstS[p.second];
-    symset_t tmpFirst = resFirst;
-    tmpFirst.erase(EPSILON); // First(A) - {epsilon}
-    resSelect.insert(tmpFirst.begin(), tmpFirst.end());
-    debug(1) << "Select(" << p.first << " -> " << vec2str(p.second);
-    debug_u(1) << ") <- " << set2str(tmpFirst) << endl;
-    if (_find(resFirst, EPSILON))
-    {
-        symset_t resFollow = calcFollowOf(p.first);
-        resSelect.insert(resFollow.begin(), resFollow.end());
-        debug(1) << "Select(" << p.first << " -> " << vec2str(p.second);
-        debug_u(1) << ") <- " << set2str(resFollow) << endl;
-    }
-    return resSelect;
-}
-
-void PredictiveGrammar::calcFirst()
-{
-    info << "Calculating First(S)..." << endl;
-    for (auto &p : products)
-    {
-        calcFirstOf(p.first);
-        calcFirstOf(p.second);
-    }
-}
-
-void PredictiveGrammar::calcFollow()
-{
-    info << "Calculating Follow..." << endl;
-    for (auto &it : nonTerms)
-    {
-        calcFollowOf(it);
-    }
-}
-
-void PredictiveGrammar::calcSelect()
-{
-    info << "Calculating Select..." << endl;
-    for (auto pdt : products)
-    {
-        select[pdt] = calcSelectOf(pdt);
-    }
-}
-
-void PredictiveGrammar::calcFirstWithLeftRecursion()
+/**
+ * @brief 计算First/Follow/Select集
+ * 在整数编号的文法上以位集合求解（见IntPredictiveGrammar），再转换为以名称表示的集合
+ * 直接或间接左递归的文法同样适用，无需单独处理
+ */
+void PredictiveGrammar::calcPredictSets()
 {
-    info << "Calculating First with Left Recursion..." << endl;
-    // 计算终结符的First集
-    for (auto &t : terminals)
-    {
-        first[t].insert(t);
-    }
-    // 计算非终结符的First集
-    bool flag, changed = true;
-    while (changed)
-    {
-        changed = false;
-        for (auto &A : nonTerms)
+    info << "Calculating First, Follow and Select..." << endl;
+    first.clear();
+    firstS.clear();
+    follow.clear();
+    select.clear();
+    IntPredictiveGrammar g(*this);
+    auto names = [&](const Bitset &bits, bool eps)
+    {
+        symset_t res;
+        bits.foreach ([&](size_t t)
+                      { res.insert(g.name(t)); });
+        if (eps)
+            res.insert(EPSILON);
+        return res;
+    };
+    for (size_t v = 0; v < g.nonTermCount(); v++)
+    {
+        const symbol_t &A = g.name(g.ntSymbol(v));
+        first[A] = names(g.first[v], g.nullable[v]);
+        follow[A] = names(g.follow[v], false);
+    }
+    for (size_t i = 0; i < products.size(); i++)
+    {
+        const symstr_t &right = products[i].second;
+        if (!_find(firstS, right))
         {
-            for (auto &right : rules[A])
-            {
-                if (right.size() == 0)
-                {
-                    insert_if_not_exist(A, EPSILON);
-                    continue;
-                }
-                bool allHaveEpsilon = true;
-                for (auto it = right.begin(); it != right.end(); it++)
-                {
-                    if (_find(terminals, *it))
-                    {
-                        insert_if_not_exist(A, *it);
-                        allHaveEpsilon = false;
-                        break;
-                    }
-                    else
-                    {
-                        symset_t resFirst = first[*it];
-                        symset_t tmpFirst = resFirst;
-                        tmpFirst.erase(EPSILON);
-                        for (auto &f : tmpFirst)
-                        {
-                            insert_if_not_exist(A, f);
-                        }
-                        if (!_find(resFirst, EPSILON))
-                        {
-                            allHaveEpsilon = false;
-                            break;
-                        }
-                    }
-                }
-                if (allHaveEpsilon)
-                {
-                    insert_if_not_exist(A, EPSILON);
-                }
-            }
+            Bitset bits(g.terminalCount());
+            bool eps = g.firstOf(g.products[i].right, 0, bits);
+            firstS[right] = names(bits, eps);
         }
-    }
-    // 计算符号串的First集
-    for (auto &p : products)
-    {
-        calcFirstOf(p.second);
+        select[products[i]] = names(g.select[i], false);
     }
 }
 
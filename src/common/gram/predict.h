@@ -15,15 +15,7 @@
 class PredictiveGrammar : public Grammar
 {
 protected:
-    bool hasLeftRecursion = false;
-    symset_t calcFirstOf(symbol_t t);
-    symset_t calcFirstOf(symstr_t s);
-    symset_t calcFollowOf(symbol_t t);
-    symset_t calcSelectOf(product_t p);
-    void calcFirst();
-    void calcFollow();
-    void calcSelect();
-    void calcFirstWithLeftRecursion();
+    void calcPredictSets();
 
 public:
     std::map<symbol_t, symset_t> first;
@@ -33,9 +25,7 @@ public:
     PredictiveGrammar() : Grammar(){};
     PredictiveGrammar(const Grammar &g) : Grammar(g)
     {
-        calcFirst();
-        calcFollow();
-        calcSelect();
+        calcPredictSets();
     }
     PredictiveGrammar(const PredictiveGrammar &g) : Grammar(g)
     {
@@ -92,32 +92,173 @@ void SLR1Grammar::calcSLR1Table()
     info << "Calculating SLR(1) table..." << endl;
     // 填入规约动作
     for (size_t i = 0; i < clusters.size(); i++)
+        calcReduceActions(i);
+    calcShiftActions();
+}
+
+void SLR1Grammar::calcReduceActions(state_id_t i)
+{
+    for (auto &item : clusters[i])
     {
-        for (auto &item : clusters[i])
+        symbol_t left = item.first.get().first;
+        symstr_t right = item.first.get().second;
+        size_t pos = item.second;
+        if (pos == right.size())
         {
-            symbol_t left = item.first.get().first;
-            symstr_t right = item.first.get().second;
-            size_t pos = item.second;
-            if (pos == right.size())
+            if (left == symStart)
             {
-                if (left == symStart)
+                coord_t coord(i, SYM_END);
+                action_t action(true);
+                slr1Table[coord] = action;
+            }
+            else
+            {
+                for (auto &t : follow[left])
                 {
-                    coord_t coord(i, SYM_END);
-                    action_t action(true);
+                    coord_t coord(i, t);
+                    action_t action(item.first);
                     slr1Table[coord] = action;
                 }
-                else
-                {
-                    for (auto &t : follow[left])
-                    {
-                        coord_t coord(i, t);
-                        action_t action(item.first);
-                        slr1Table[coord] = action;
-                    }
-                }
             }
         }
     }
+}
+
+/**
+ * @brief 以修改后的文法增量更新
+ * 终结符、非终结符和开始符号不变时，只重新计算受影响的项目集，并就地修补分析表：
+ * 未受影响且规约项目的Follow集不变的状态保留原有的规约动作，其余状态重新填写
+ * 符号发生变化时退回到完整构造
+ *
+ * @param g 修改后的文法
+ * @return size_t 重新填写规约动作的状态数
+ */
+size_t SLR1Grammar::update(const Grammar &g)
+{
+    info << "SLR1Grammar: Updating grammar incrementally..." << endl;
+    bool rebuild = g.terminals != terminals || g.nonTerms != nonTerms || g.symStart != symStart;
+    // 按值对应新旧产生式，找出产生式发生变化的非终结符
+    map<product_t, size_t> newIndex;
+    for (size_t p = 0; p < g.products.size(); p++)
+        newIndex[g.products[p]] = p;
+    vector<size_t> prodMap(products.size(), SIZE_MAX); // 旧产生式下标 -> 新下标
+    vector<bool> matched(g.products.size(), false);
+    symset_t changed;
+    for (size_t p = 0; p < products.size(); p++)
+    {
+        auto it = newIndex.find(products[p]);
+        if (it == newIndex.end())
+        {
+            changed.insert(products[p].first);
+            continue;
+        }
+        prodMap[p] = it->second;
+        matched[it->second] = true;
+    }
+    for (size_t p = 0; p < g.products.size(); p++)
+        if (!matched[p])
+            changed.insert(g.products[p].first);
+    debug(0) << "SLR1Grammar: Changed non-terminals: " << set2str(changed) << endl;
+
+    // 旧的项目集和分析表引用旧的产生式，更新完成前保持其有效
+    vector<product_t> oldProducts;
+    oldProducts.swap(products);
+    map<symbol_t, symset_t> oldFollow = follow;
+    static_cast<Grammar &>(*this) = g;
+    calcPredictSets();
+    if (rebuild)
+    {
+        warn << "SLR1Grammar: Symbols changed, rebuilding..." << endl;
+        rebuildClusters();
+        slr1Table.clear();
+        calcSLR1Table();
+        return clusters.size();
+    }
+    vector<size_t> remap;
+    vector<bool> redo = updateClusters(oldProducts, prodMap, changed, remap);
+
+    // 规约项目的Follow集发生变化的状态同样需要重新填写
+    // 须按项目集中的规约项目判断，而不是按分析表中现存的规约动作：被移进或其他规约覆盖的动作、
+    // 以及原Follow集为空的规约项目都不会出现在表中
+    for (size_t s = 0; s < clusters.size(); s++)
+    {
+        if (redo[s])
+            continue;
+        for (auto &item : clusters[s])
+        {
+            const symbol_t &left = item.first.get().first;
+            if (item.second == item.first.get().second.size() && left != symStart && follow[left] != oldFollow[left])
+            {
+                redo[s] = true;
+                break;
+            }
+        }
+    }
+    // 修补分析表：删除需要重新填写的状态的全部动作，其余的规约动作改为引用新的产生式
+    // 没有状态被删除时原有状态的编号不变，就地修改；否则按新编号重新插入
+    bool stable = true;
+    for (size_t s = 0; s < remap.size(); s++)
+        stable = stable && remap[s] == s;
+    auto repoint = [&](action_t &action)
+    {
+        if (action.index() == 1)
+            action = product_ref(products[prodMap[&get<1>(action).get() - oldProducts.data()]]);
+    };
+    if (stable)
+    {
+        for (auto it = slr1Table.begin(); it != slr1Table.end();)
+        {
+            if (redo[it->first.first])
+            {
+                it = slr1Table.erase(it);
+                continue;
+            }
+            repoint(it->second);
+            it++;
+        }
+    }
+    else
+    {
+        table_t<state_id_t, symbol_t, action_t> oldTable;
+        oldTable.swap(slr1Table);
+        for (auto &entry : oldTable)
+        {
+            size_t s = remap[entry.first.first];
+            if (s == SIZE_MAX || redo[s])
+                continue;
+            action_t action = entry.second;
+            if (action.index() == 2)
+                action = (state_id_t)remap[get<2>(action)];
+            repoint(action);
+            slr1Table.emplace_hint(slr1Table.end(), mkcrd((state_id_t)s, entry.first.second), action);
+        }
+    }
+    size_t cnt = 0;
+    for (state_id_t s = 0; s < clusters.size(); s++)
+    {
+        if (!redo[s])
+            continue;
+        calcReduceActions(s);
+        calcShiftActions(s);
+        cnt++;
+    }
+    info << "SLR1Grammar: " << cnt << " of " << clusters.size() << " states refilled." << endl;
+    return cnt;
+}
+
+// 只填入状态s的移进动作，用于增量更新
+void SLR1Grammar::calcShiftActions(state_id_t s)
+{
+    for (auto it = goTrans.lower_bound(mkcrd(s, symbol_t())); it != goTrans.end() && it->first.first == s; it++)
+    {
+        if (_find(slr1Table, it->first))
+            warn << "Conflict found in SLR(1) table! Shift action will be applied!" << endl;
+        slr1Table[it->first] = action_t(it->second);
+    }
+}
+
+void SLR1Grammar::calcShiftActions()
+{
     // 填入移进动作
     // 移进在规约之后，可以覆盖规约动作
     // 也就是说，如果有冲突，移进优先
@@ -18,11 +18,19 @@
 class SLR1Grammar : public LRGrammar
 {
     void calcSLR1Table();
+    void calcReduceActions(state_id_t i);
+
+protected:
+    // 只构造LR(0)项目集规范族，分析表由派生类以其他方式计算向前看符号后填入
+    SLR1Grammar(const Grammar &g, size_t threads, bool) : LRGrammar(g, threads) {}
+    void calcShiftActions();
+    void calcShiftActions(state_id_t s);
 
 public:
     bool checkSLR1();
+    size_t update(const Grammar &g);
     SLR1Grammar() : LRGrammar(){};
-    SLR1Grammar(const Grammar &g) : LRGrammar(g)
+    SLR1Grammar(const Grammar &g, size_t threads = 1) : LRGrammar(g, threads)
     {
         calcSLR1Table();
     }
@@ -0,0 +1,60 @@
+/**
+ * @file tok_stream.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Compact Token Stream
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "tok_stream.h"
+
+using namespace std;
+
+string &visualize(string &s)
+{
+    // 将字符串中的不可见字符转换为可见字符
+    // 比如将换行符转换为\n，将制表符转换为\t
+    for (int i = 0; i < s.length(); i++)
+    {
+        if (s[i] == '\n')
+        {
+            s.replace(i, 1, "\\n");
+        }
+        else if (s[i] == '\t')
+        {
+            s.replace(i, 1, "\\t");
+        }
+        else if (s[i] == '\r')
+        {
+            s.replace(i, 1, "\\r");
+        }
+        else if (s[i] == '\v')
+        {
+            s.replace(i, 1, "\\v");
+        }
+        else if (s[i] == '\f')
+        {
+            s.replace(i, 1, "\\f");
+        }
+    }
+    return s;
+}
+
+token TokenStream::at(size_t i) const
+{
+    string value(this->value(i));
+    size_t line, col;
+    tie(line, col) = lineCol(i);
+    return token(type(i), visualize(value), line, col);
+}
+
+vector<token> TokenStream::toTokens() const
+{
+    vector<token> tokens;
+    tokens.reserve(spans.size());
+    for (size_t i = 0; i < spans.size(); i++)
+        tokens.push_back(at(i));
+    return tokens;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file tok_stream.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Compact Token Stream
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 词法分析的紧凑输出
+ * 每个词法单元只占12个字节（类型编号 + 源文本区间），不为值分配字符串
+ * 源文本由共享缓冲区的视图持有，值以string_view的形式直接指向源文本
+ * 行列号只在被访问时通过行表二分查找计算
+ */
+
+#pragma once
+
+#include "token.h"
+#include "utils/view/ctx_view.h"
+
+#include <vector>
+#include <string>
+#include <string_view>
+
+std::string &visualize(std::string &s); // 将不可见字符转换为转义形式
+
+class TokenStream
+{
+    ContextViewer source;          // 源文本，与词法分析时的视图共享缓冲区
+    std::vector<token_span> spans; // 词法单元序列
+
+public:
+    TokenStream(const Viewer &source) : source(source) {}
+
+    void push(tok_id_t type, size_t offset, size_t length)
+    {
+        spans.push_back({type, (uint32_t)offset, (uint32_t)length});
+    }
+    void reserve(size_t n)
+    {
+        spans.reserve(n);
+    }
+    size_t size() const
+    {
+        return spans.size();
+    }
+    bool empty() const
+    {
+        return spans.empty();
+    }
+    const token_span &operator[](size_t i) const
+    {
+        return spans[i];
+    }
+    tok_id_t typeId(size_t i) const
+    {
+        return spans[i].type;
+    }
+    // 修改第i个词法单元的类型，用于文法的终结符映射
+    void retype(size_t i, tok_id_t type)
+    {
+        spans[i].type = type;
+    }
+    const token_type_t &type(size_t i) const
+    {
+        return tokTypeOf(spans[i].type);
+    }
+    // 词法单元的原始值，直接指向源文本
+    std::string_view value(size_t i) const
+    {
+        return source.getView().substr(spans[i].offset, spans[i].length);
+    }
+    // 词法单元结尾处的行列号（与token::line/col的约定一致）
+    code_loc_t lineCol(size_t i) const
+    {
+        return source.locate(spans[i].offset + spans[i].length);
+    }
+    const ContextViewer &getSource() const
+    {
+        return source;
+    }
+
+    token at(size_t i) const;            // 物化为传统的token
+    std::vector<token> toTokens() const; // 物化整个序列，供使用std::vector<token>的接口
+};
@@ -10,6 +10,41 @@
 
 #include "token.h"
 
+#include <vector>
+#include <unordered_map>
+
 using namespace std;
 
-map<string, token_type_t> tokTypeMap;
\ No newline at end of file
+map<string, token_type_t> tokTypeMap;
+
+static vector<token_type_t> tokTypeVec;
+static unordered_map<string, tok_id_t> tokIdMap;
+
+tok_id_t internTokType(const token_type_t &type)
+{
+    auto it = tokIdMap.find(*type);
+    if (it != tokIdMap.end())
+        return it->second;
+    tok_id_t id = tokTypeVec.size();
+    tokTypeVec.push_back(type);
+    tokIdMap[*type] = id;
+    return id;
+}
+
+tok_id_t internTokType(const string &name)
+{
+    auto it = tokIdMap.find(name);
+    if (it != tokIdMap.end())
+        return it->second;
+    return internTokType(make_tok_type(name));
+}
+
+const token_type_t &tokTypeOf(tok_id_t id)
+{
+    return tokTypeVec[id];
+}
+
+size_t tokTypeCount()
+{
+    return tokTypeVec.size();
+}
@@ -13,6 +13,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <cstdint>
 
 using token_type_t = std::shared_ptr<std::string>;
 #define token_iter_t std::vector<token>::iterator
@@ -26,6 +27,30 @@ using token_type_t = std::shared_ptr<std::string>;
 
 extern std::map<std::string, token_type_t> tokTypeMap;
 
+/**
+ * 词法单元类型的整数编号
+ * 同名的类型共享同一个编号，编号从0开始连续分配
+ */
+using tok_id_t = uint32_t;
+constexpr tok_id_t TOK_ID_NONE = UINT32_MAX;
+
+tok_id_t internTokType(const std::string &name);  // 获取（必要时分配）类型名对应的编号
+tok_id_t internTokType(const token_type_t &type); // 同上，首次出现时沿用传入的类型指针
+const token_type_t &tokTypeOf(tok_id_t id);       // 编号 -> 类型
+size_t tokTypeCount();                            // 已分配的编号数量
+
+/**
+ * @brief 紧凑的词法单元
+ * 只记录类型编号和在源文本中的区间，不拷贝词法单元的值
+ * 值和行列号在需要时由所属的TokenStream从源文本中计算
+ */
+struct token_span
+{
+    tok_id_t type;
+    uint32_t offset;
+    uint32_t length;
+};
+
 /**
  * @brief Token
  */
@@ -0,0 +1,63 @@
+/**
+ * @file tree/arena.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Arena-allocated Parse Tree
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "arena.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief 转换为以shared_ptr连接的语法树，供RST/AST的构建和语义分析使用
+ * 结点下标的升序即后序，按下标顺序依次创建即可保证子结点先于父结点，无需递归
+ *
+ * @param grammar 建树时使用的文法，非终结符结点附加其中的产生式
+ * @param tokens 建树时使用的词法单元序列
+ * @param roots 需要的各子树的根结点，须互不包含
+ * @return vector<pst_node_ptr_t> 各子树转换后的根结点
+ */
+vector<pst_node_ptr_t> ArenaTree::toPST(Grammar &grammar, const TokenStream &tokens, span<const arena_node_id_t> roots) const
+{
+    vector<pst_node_ptr_t> made(nodes.size());
+    size_t last = 0;
+    for (auto root : roots)
+        last = max(last, (size_t)root + 1);
+    for (arena_node_id_t id = 0; id < last; id++)
+    {
+        const arena_node_t &n = nodes[id];
+        if (n.product == ARENA_TERMINAL)
+        {
+            token tok = tokens.at(n.token);
+            made[id] = pst_tree_t::createNode(TERMINAL, tok.value, tok.line, tok.col);
+            continue;
+        }
+        product_t &product = grammar.products[n.product];
+        pst_node_ptr_t node = pst_tree_t::createNode(NON_TERM, product.first, 0, 0);
+        node->attachProduct(product);
+        for (auto child : childrenOf(id))
+        {
+            *node << made[child];
+            made[child] = nullptr;
+        }
+        made[id] = node;
+    }
+    vector<pst_node_ptr_t> res;
+    for (auto root : roots)
+        res.push_back(made[root]);
+    return res;
+}
+
+pst_tree_ptr_t ArenaTree::toPST(Grammar &grammar, const TokenStream &tokens) const
+{
+    if (nodes.empty())
+        return nullptr;
+    arena_node_id_t r = root();
+    return toPST(grammar, tokens, span<const arena_node_id_t>(&r, 1))[0];
+}
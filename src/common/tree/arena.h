@@ -0,0 +1,89 @@
+/**
+ * @file tree/arena.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Arena-allocated Parse Tree
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 连续存储的语法树
+ * 所有结点存放在同一个数组中，以下标引用；每个非终结符结点的子结点是共享子结点数组中的一段连续区间
+ * 结点不复制产生式和词法单元的值：非终结符结点只记录产生式编号（Grammar::products的下标），
+ * 终结符结点只记录词法单元在TokenStream中的下标
+ * LR分析自底向上建树，子结点总是先于父结点创建，因此结点下标的升序就是树的后序
+ * 释放整棵树只需清空两个数组（保留容量，可直接用于下一次分析）
+ */
+
+#pragma once
+
+#include "pst.h"
+#include "common/tok_stream.h"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+using arena_node_id_t = uint32_t;
+
+constexpr uint32_t ARENA_TERMINAL = UINT32_MAX; // 终结符结点的产生式编号
+
+struct arena_node_t
+{
+    uint32_t product; // 产生式编号，终结符结点为ARENA_TERMINAL
+    uint32_t token;   // 终结符结点对应的词法单元下标
+    uint32_t first;   // 子结点在子结点数组中的起始下标
+    uint32_t count;   // 子结点个数
+};
+
+class ArenaTree
+{
+    std::vector<arena_node_t> nodes;
+    std::vector<arena_node_id_t> children;
+
+public:
+    // 清空整棵树，保留已分配的空间
+    void reset()
+    {
+        nodes.clear();
+        children.clear();
+    }
+    void reserve(size_t tokens)
+    {
+        nodes.reserve(tokens * 2);
+        children.reserve(tokens * 2);
+    }
+    arena_node_id_t leaf(size_t token)
+    {
+        nodes.push_back({ARENA_TERMINAL, (uint32_t)token, 0, 0});
+        return nodes.size() - 1;
+    }
+    // 以产生式p规约，kids为按产生式右部顺序排列的子结点
+    arena_node_id_t reduce(size_t p, std::span<const arena_node_id_t> kids)
+    {
+        nodes.push_back({(uint32_t)p, 0, (uint32_t)children.size(), (uint32_t)kids.size()});
+        children.insert(children.end(), kids.begin(), kids.end());
+        return nodes.size() - 1;
+    }
+
+    size_t size() const { return nodes.size(); }
+    bool empty() const { return nodes.empty(); }
+    // 最后创建的结点即为根结点
+    arena_node_id_t root() const { return nodes.size() - 1; }
+    const arena_node_t &operator[](arena_node_id_t id) const { return nodes[id]; }
+    bool isTerminal(arena_node_id_t id) const { return nodes[id].product == ARENA_TERMINAL; }
+    std::span<const arena_node_id_t> childrenOf(arena_node_id_t id) const
+    {
+        return std::span<const arena_node_id_t>(children.data() + nodes[id].first, nodes[id].count);
+    }
+    // 树本身占用的字节数（不含预留的空间）
+    size_t bytes() const
+    {
+        return nodes.size() * sizeof(arena_node_t) + children.size() * sizeof(arena_node_id_t);
+    }
+
+    pst_tree_ptr_t toPST(Grammar &grammar, const TokenStream &tokens) const;
+    std::vector<pst_node_ptr_t> toPST(Grammar &grammar, const TokenStream &tokens, std::span<const arena_node_id_t> roots) const;
+};
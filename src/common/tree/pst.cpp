@@ -30,7 +30,7 @@ pst_node_ptr_t ParseSyntaxTreeNode::createNode(pst_node_data data)
     return make_shared<pst_node_t>(data);
 }
 
-pst_node_t &ParseSyntaxTreeNode::attachProduct(product_t &product)
+pst_node_t &ParseSyntaxTreeNode::attachProduct(const product_t &product)
 {
     data.product_opt = product;
     return *this;
@@ -50,7 +50,7 @@ public:
     static pst_node_ptr_t createNode(node_type type, const std::string &symbol, size_t line, size_t col);
     static pst_node_ptr_t createNode(pst_node_data data);
 
-    pst_node_t &attachProduct(product_t &product);
+    pst_node_t &attachProduct(const product_t &product);
     pst_node_t &attachSemantic(semantic_t &semantic);
 
     pst_node_t &operator[](size_t index) const;
@@ -106,14 +106,12 @@ public:
         std::for_each(this->begin(), this->end(), nodeF);
     }
 
+    // 非递归的后序遍历，f(const pst_node_t &)
     template <typename func_t>
     void postorder(func_t f) const
     {
-        foreach (
-            [=](pst_node_t &ref)
-            { ref.postorder(f); })
-            ;
-        f(*this);
+        for (auto &node : walkPostorder(*this))
+            f(node);
     }
 
     std::string descData() const override;
@@ -20,6 +20,7 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <utility>
 
 template <typename data_t>
 class AbstractTreeNode;
@@ -33,6 +34,184 @@ using tree_node_ptr_t = std::shared_ptr<AbstractTreeNode<data_t>>;
 template <typename data_t>
 using tree_children_t = std::vector<tree_node_ptr_t<data_t>>;
 
+/**
+ * 树的非递归遍历
+ * 以显式栈代替递归调用，遍历的深度不受调用栈大小的限制，适用于由长列表右递归展开得到的极深的树
+ * 迭代器直接给出结点的引用，遍历过程中不复制结点，也不为每个结点分配内存：
+ * 先序、后序遍历的栈只在树变深时增长，层序遍历的两个队列只在树变宽时增长
+ * node_t为结点类型（AbstractTreeNode或其派生类，可带const限定），子结点以static_cast转换为node_t
+ * 遍历过程中不能增删正在遍历的子树中的结点
+ *
+ *     for (auto &node : walkPostorder(*root))
+ *         ...
+ */
+
+template <typename node_t>
+inline node_t &childOf(node_t &node, size_t index)
+{
+    return static_cast<node_t &>(*node.at(index));
+}
+
+template <typename node_t>
+class PreorderWalker
+{
+    node_t *root;
+
+public:
+    class iterator
+    {
+        // 待访问的结点及其深度，栈顶为当前结点
+        std::vector<std::pair<node_t *, size_t>> stk;
+
+    public:
+        iterator() = default;
+        iterator(node_t *root)
+        {
+            if (root)
+                stk.push_back({root, 0});
+        }
+        node_t &operator*() const { return *stk.back().first; }
+        node_t *operator->() const { return stk.back().first; }
+        // 当前结点的深度，根结点为0
+        size_t depth() const { return stk.back().second; }
+        iterator &operator++()
+        {
+            auto [node, d] = stk.back();
+            stk.pop_back();
+            // 逆序压栈，使第一个子结点最先被访问
+            for (size_t i = node->size(); i-- > 0;)
+                stk.push_back({&childOf(*node, i), d + 1});
+            return *this;
+        }
+        bool operator==(const iterator &other) const
+        {
+            if (stk.empty() || other.stk.empty())
+                return stk.empty() == other.stk.empty();
+            return stk.back().first == other.stk.back().first;
+        }
+    };
+
+    PreorderWalker(node_t &root) : root(&root) {}
+    iterator begin() const { return iterator(root); }
+    iterator end() const { return iterator(); }
+};
+
+template <typename node_t>
+class PostorderWalker
+{
+    node_t *root;
+
+public:
+    class iterator
+    {
+        // 根结点到当前结点的路径，以及路径上各结点下一个要进入的子结点，栈顶为当前结点
+        std::vector<std::pair<node_t *, size_t>> stk;
+
+        // 从栈顶结点一路进入第一个未访问的子结点，直到叶结点或子结点均已访问的结点
+        void descend()
+        {
+            while (stk.back().second < stk.back().first->size())
+            {
+                node_t *child = &childOf(*stk.back().first, stk.back().second++);
+                stk.push_back({child, 0});
+            }
+        }
+
+    public:
+        iterator() = default;
+        iterator(node_t *root)
+        {
+            if (root)
+            {
+                stk.push_back({root, 0});
+                descend();
+            }
+        }
+        node_t &operator*() const { return *stk.back().first; }
+        node_t *operator->() const { return stk.back().first; }
+        // 当前结点的深度，根结点为0
+        size_t depth() const { return stk.size() - 1; }
+        iterator &operator++()
+        {
+            stk.pop_back();
+            if (!stk.empty())
+                descend();
+            return *this;
+        }
+        bool operator==(const iterator &other) const
+        {
+            if (stk.empty() || other.stk.empty())
+                return stk.empty() == other.stk.empty();
+            return stk.back().first == other.stk.back().first;
+        }
+    };
+
+    PostorderWalker(node_t &root) : root(&root) {}
+    iterator begin() const { return iterator(root); }
+    iterator end() const { return iterator(); }
+};
+
+template <typename node_t>
+class LevelorderWalker
+{
+    node_t *root;
+
+public:
+    class iterator
+    {
+        // 当前层与下一层的结点，cur[pos]为当前结点
+        std::vector<node_t *> cur, next;
+        size_t pos = 0, level = 0;
+
+    public:
+        iterator() = default;
+        iterator(node_t *root)
+        {
+            if (root)
+                cur.push_back(root);
+        }
+        node_t &operator*() const { return *cur[pos]; }
+        node_t *operator->() const { return cur[pos]; }
+        // 当前结点的深度，根结点为0
+        size_t depth() const { return level; }
+        iterator &operator++()
+        {
+            node_t *node = cur[pos++];
+            for (size_t i = 0; i < node->size(); i++)
+                next.push_back(&childOf(*node, i));
+            if (pos == cur.size())
+            {
+                // 当前层访问完毕，交换两个队列，保留已分配的空间
+                std::swap(cur, next);
+                next.clear();
+                pos = 0;
+                level++;
+            }
+            return *this;
+        }
+        bool operator==(const iterator &other) const
+        {
+            bool done = pos >= cur.size(), otherDone = other.pos >= other.cur.size();
+            if (done || otherDone)
+                return done == otherDone;
+            return cur[pos] == other.cur[other.pos];
+        }
+    };
+
+    LevelorderWalker(node_t &root) : root(&root) {}
+    iterator begin() const { return iterator(root); }
+    iterator end() const { return iterator(); }
+};
+
+template <typename node_t>
+PreorderWalker<node_t> walkPreorder(node_t &root) { return PreorderWalker<node_t>(root); }
+
+template <typename node_t>
+PostorderWalker<node_t> walkPostorder(node_t &root) { return PostorderWalker<node_t>(root); }
+
+template <typename node_t>
+LevelorderWalker<node_t> walkLevelorder(node_t &root) { return LevelorderWalker<node_t>(root); }
+
 template <typename data_t>
 class AbstractTreeNode : public tree_children_t<data_t>
 {
@@ -107,110 +286,51 @@ public:
         for_each(tree_children_t<data_t>::begin(), tree_children_t<data_t>::end(), nodeF);
     }
 
+    // 先序遍历，f(const tree_node_t &)
     template <typename func_t>
     void traverse(func_t f) const
     {
-        f(*this);
-        foreach (
-            [=](tree_node_t<data_t> &ref)
-            { ref.traverse(f); })
-            ;
-    }
-
-    template <typename func_t>
-    void traverse(func_t f, int &level, int &index)
-    {
-        tree_node_t<data_t> &self = *this;
-        f(self);
-        level++;
-        int tmpIdx = index++;
-        index = 0;
-        foreach (
-            [&](tree_node_t<data_t> &ref)
-            {
-                ref.traverse(f, level, index);
-                index++;
-            })
-            ;
-        level--;
-        index = tmpIdx;
+        for (auto &node : walkPreorder(*this))
+            f(node);
     }
 
+    // 后序遍历，f(const tree_node_t &)
     template <typename func_t>
     void postorder(func_t f) const
     {
-        foreach (
-            [=](tree_node_t<data_t> &ref)
-            { ref.postorder(f); })
-            ;
-        f(*this);
+        for (auto &node : walkPostorder(*this))
+            f(node);
     }
 
-    template <typename func_t>
-    void postorder(func_t f, int &level, int &index)
-    {
-        tree_node_t<data_t> &self = *this;
-        level++;
-        int tmpIdx = index++;
-        index = 0;
-        foreach (
-            [&](tree_node_t<data_t> &ref)
-            {
-                ref.postorder(f, level, index);
-                index++;
-            })
-            ;
-        level--;
-        index = tmpIdx;
-        f(self);
-    }
-
-    std::string dumpTree()
+    std::string dumpTree() const
     {
         std::stringstream ss;
+        // visible[i]表示第i层的竖线是否需要继续画下去（即第i+1层的结点是否还有后续的兄弟结点）
         std::vector<bool> visible;
-        int level = 0;
-        int index = 0;
-        traverse(
-            [&](tree_node_t<data_t> &node)
+        auto range = walkPreorder(*this);
+        for (auto it = range.begin(); it != range.end(); ++it)
+        {
+            const tree_node_t<data_t> &node = *it;
+            size_t level = it.depth();
+            if (visible.size() <= level)
+                visible.resize(level + 1, true);
+            if (level > 0)
             {
-                if (visible.size() <= level)
-                    visible.push_back(true);
-                if (level > 0)
+                if (node.parent == nullptr)
                 {
-                    if (node.parent == nullptr)
-                    {
-                        warn << "DumpTree: Node <" << node.descData() << "> has no parent!" << std::endl;
-                    }
-                    else if (index == node.parent->size() - 1)
-                    {
-                        visible[level - 1] = false;
-                    }
+                    warn << "DumpTree: Node <" << node.descData() << "> has no parent!" << std::endl;
                 }
-                auto getHead = [=](int level) -> std::string
+                else
                 {
-                    int i = 0;
-                    std::string ret;
-                    while (i < level - 1)
-                    {
-                        if (visible[i])
-                            ret += "|  ";
-                        else
-                            ret += "   ";
-                        i++;
-                    }
-                    if (level > 0)
-                        ret += "|--";
-                    return ret;
-                };
-                ss << getHead(level);
-                ss << node.descData();
-                ss << std::endl;
-                if (level > 0)
-                    for (int i = level; i < visible.size(); i++)
-                        visible[i] = true;
-            },
-            level, index);
+                    // 是否为父结点的最后一个子结点
+                    visible[level - 1] = node.parent->back().get() != &node;
+                }
+                for (size_t i = 0; i + 1 < level; i++)
+                    ss << (visible[i] ? "|  " : "   ");
+                ss << "|--";
+            }
+            ss << node.descData() << std::endl;
+        }
         return ss.str();
     }
 
@@ -0,0 +1,138 @@
+/**
+ * @file charset.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief 256-bit Character Class
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 以256位位图表示的字符类（按字节）
+ * 正则表达式中的[...]、\w、\d、.等字符类在构造NFA时保持为一个位图，
+ * 每个字符类只产生一条转移，而不是逐字符各产生一条
+ * 位图也可以表示至多256个编号的集合，如DFA构造时的字节等价类集合
+ */
+
+#pragma once
+
+#include <bit>
+#include <set>
+#include <string>
+#include <cstdint>
+
+class CharSet
+{
+    uint64_t bits[4] = {0, 0, 0, 0};
+
+public:
+    CharSet() = default;
+    CharSet(const std::set<char> &chars)
+    {
+        for (char c : chars)
+            insert(c);
+    }
+    static CharSet of(unsigned char c)
+    {
+        CharSet s;
+        s.insert(c);
+        return s;
+    }
+    // 闭区间[lo, hi]
+    static CharSet range(unsigned char lo, unsigned char hi)
+    {
+        CharSet s;
+        s.insert(lo, hi);
+        return s;
+    }
+
+    void insert(unsigned char c) { bits[c >> 6] |= uint64_t(1) << (c & 63); }
+    void insert(unsigned char lo, unsigned char hi)
+    {
+        for (unsigned c = lo; c <= hi; c++)
+            insert((unsigned char)c);
+    }
+    void erase(unsigned char c) { bits[c >> 6] &= ~(uint64_t(1) << (c & 63)); }
+    bool contains(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+    bool empty() const { return (bits[0] | bits[1] | bits[2] | bits[3]) == 0; }
+    size_t count() const
+    {
+        return std::popcount(bits[0]) + std::popcount(bits[1]) + std::popcount(bits[2]) + std::popcount(bits[3]);
+    }
+
+    CharSet &operator|=(const CharSet &o)
+    {
+        for (int i = 0; i < 4; i++)
+            bits[i] |= o.bits[i];
+        return *this;
+    }
+    CharSet &operator&=(const CharSet &o)
+    {
+        for (int i = 0; i < 4; i++)
+            bits[i] &= o.bits[i];
+        return *this;
+    }
+    CharSet &operator-=(const CharSet &o)
+    {
+        for (int i = 0; i < 4; i++)
+            bits[i] &= ~o.bits[i];
+        return *this;
+    }
+    CharSet operator~() const
+    {
+        CharSet s;
+        for (int i = 0; i < 4; i++)
+            s.bits[i] = ~bits[i];
+        return s;
+    }
+    bool operator==(const CharSet &o) const
+    {
+        return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2] && bits[3] == o.bits[3];
+    }
+    bool operator<(const CharSet &o) const
+    {
+        for (int i = 0; i < 4; i++)
+            if (bits[i] != o.bits[i])
+                return bits[i] < o.bits[i];
+        return false;
+    }
+
+    // 按升序遍历集合中的元素，f(unsigned c)
+    template <typename func_t>
+    void foreach (func_t f) const
+    {
+        for (unsigned i = 0; i < 4; i++)
+            for (uint64_t w = bits[i]; w != 0; w &= w - 1)
+                f(i * 64 + std::countr_zero(w));
+    }
+
+    // 以[a-z_]的形式描述，连续的字节合并为区间
+    std::string desc() const
+    {
+        auto chr = [](unsigned c) -> std::string
+        {
+            if (c > 0x20 && c < 0x7f)
+                return std::string(1, (char)c);
+            return "(" + std::to_string(c) + ")";
+        };
+        std::string s = "[";
+        unsigned c = 0;
+        while (c < 256)
+        {
+            if (!contains(c))
+            {
+                c++;
+                continue;
+            }
+            unsigned e = c;
+            while (e + 1 < 256 && contains(e + 1))
+                e++;
+            s += chr(c);
+            if (e > c)
+                s += "-" + chr(e);
+            c = e + 1;
+        }
+        return s + "]";
+    }
+};
@@ -0,0 +1,370 @@
+/**
+ * @file dfa.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Deterministic Finite Automaton
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "dfa.h"
+#include "flat_nfa.h"
+#include "regexp/define.h"
+#include "utils/log.h"
+
+#include <map>
+#include <algorithm>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+void DeterministicAutomaton::determinize(const vector<const FiniteAutomaton *> &nfas, const vector<dfa_tag_t> &nfaTags)
+{
+    FlatNFA flat(nfas, nfaTags);
+    debug(0) << "DFA: Determinizing NFA with " << flat.tags.size() << " states" << endl;
+    byteClass = flat.byteClass;
+    classCount = flat.classCount;
+    const size_t K = classCount;
+    map<nfa_set_t, dfa_state_t> setIds; // NFA状态集合 -> DFA状态
+    vector<nfa_set_t> sets;             // DFA状态 -> NFA状态集合
+    // 0号状态为死状态，对应空集
+    sets.push_back(nfa_set_t());
+    setIds[nfa_set_t()] = DFA_DEAD;
+    table.assign(K, DFA_DEAD);
+    tags.assign(1, DFA_NO_TAG);
+    auto addSet = [&](nfa_set_t &&s) -> dfa_state_t
+    {
+        auto it = setIds.find(s);
+        if (it != setIds.end())
+            return it->second;
+        dfa_state_t id = sets.size();
+        dfa_tag_t tag = DFA_NO_TAG;
+        for (auto i : s)
+            tag = min(tag, flat.tags[i]); // 取优先级最高（标签最小）的规则
+        setIds[s] = id;
+        sets.push_back(move(s));
+        table.resize(sets.size() * K, DFA_DEAD);
+        tags.push_back(tag);
+        return id;
+    };
+    startState = addSet(flat.closure(flat.starts));
+    vector<vector<state_id_t>> buckets(K);
+    // sets在循环中会增长，因此按下标遍历
+    for (dfa_state_t i = 1; i < sets.size(); i++)
+    {
+        for (auto s : sets[i])
+            for (auto &e : flat.edges[s])
+                e.first.foreach ([&](unsigned k)
+                                 { buckets[k].push_back(e.second); });
+        for (size_t k = 0; k < K; k++)
+        {
+            if (buckets[k].empty())
+                continue;
+            dfa_state_t to = addSet(flat.closure(buckets[k]));
+            table[i * K + k] = to;
+            buckets[k].clear();
+        }
+    }
+    stateCount = sets.size();
+    debug(0) << "DFA: " << stateCount << " states, " << K << " byte classes after subset construction" << endl;
+}
+
+void DeterministicAutomaton::minimize()
+{
+    const size_t n = stateCount;
+    const size_t A = classCount;
+    // 反向转移表（CSR格式），invSrc[invStart[t * A + c] ... invStart[t * A + c + 1]]
+    // 为所有经过等价类c转移到t的状态
+    vector<uint32_t> invStart(n * A + 1, 0);
+    vector<uint32_t> invSrc(n * A);
+    for (size_t s = 0; s < n; s++)
+        for (size_t c = 0; c < A; c++)
+            invStart[table[s * A + c] * A + c + 1]++;
+    for (size_t i = 1; i <= n * A; i++)
+        invStart[i] += invStart[i - 1];
+    {
+        vector<uint32_t> fill(invStart.begin(), invStart.end() - 1);
+        for (size_t s = 0; s < n; s++)
+            for (size_t c = 0; c < A; c++)
+                invSrc[fill[table[s * A + c] * A + c]++] = s;
+    }
+    // 初始划分：标签相同的状态归为一类（非终态的标签均为DFA_NO_TAG）
+    vector<vector<dfa_state_t>> blocks;
+    vector<uint32_t> blockOf(n);
+    {
+        map<dfa_tag_t, uint32_t> tagBlocks;
+        for (dfa_state_t s = 0; s < n; s++)
+        {
+            auto it = tagBlocks.find(tags[s]);
+            if (it == tagBlocks.end())
+            {
+                it = tagBlocks.insert(make_pair(tags[s], (uint32_t)blocks.size())).first;
+                blocks.push_back(vector<dfa_state_t>());
+            }
+            blockOf[s] = it->second;
+            blocks[it->second].push_back(s);
+        }
+    }
+    // 待处理的 (状态等价类, 字节等价类) 对
+    vector<pair<uint32_t, uint32_t>> work;
+    vector<bool> inWork(blocks.size() * A, false);
+    for (uint32_t b = 0; b < blocks.size(); b++)
+        for (uint32_t c = 0; c < A; c++)
+        {
+            work.push_back(make_pair(b, c));
+            inWork[b * A + c] = true;
+        }
+    vector<bool> marked(n, false);
+    vector<uint32_t> markCnt(n, 0);
+    vector<dfa_state_t> pre;
+    vector<uint32_t> touched;
+    while (!work.empty())
+    {
+        uint32_t a, c;
+        tie(a, c) = work.back();
+        work.pop_back();
+        inWork[a * A + c] = false;
+        // 计算经过字节等价类c可到达状态等价类a的状态集合
+        pre.clear();
+        touched.clear();
+        for (auto t : blocks[a])
+        {
+            for (uint32_t k = invStart[t * A + c]; k < invStart[t * A + c + 1]; k++)
+            {
+                dfa_state_t x = invSrc[k];
+                pre.push_back(x);
+                marked[x] = true;
+                if (markCnt[blockOf[x]]++ == 0)
+                    touched.push_back(blockOf[x]);
+            }
+        }
+        // 分裂被部分命中的等价类
+        for (auto b : touched)
+        {
+            if (markCnt[b] < blocks[b].size())
+            {
+                uint32_t nb = blocks.size();
+                vector<dfa_state_t> keep, moved;
+                for (auto s : blocks[b])
+                    (marked[s] ? moved : keep).push_back(s);
+                blocks[b] = move(keep);
+                for (auto s : moved)
+                    blockOf[s] = nb;
+                blocks.push_back(move(moved));
+                inWork.resize(blocks.size() * A, false);
+                for (uint32_t d = 0; d < A; d++)
+                {
+                    uint32_t target = nb;
+                    if (!inWork[b * A + d] && blocks[b].size() < blocks[nb].size())
+                        target = b;
+                    if (!inWork[target * A + d])
+                    {
+                        work.push_back(make_pair(target, d));
+                        inWork[target * A + d] = true;
+                    }
+                }
+            }
+            markCnt[b] = 0;
+        }
+        for (auto x : pre)
+            marked[x] = false;
+    }
+    // 重新编号：死状态所在等价类编号为0，其余按首次出现的顺序编号
+    vector<dfa_state_t> newId(blocks.size(), (dfa_state_t)-1);
+    dfa_state_t cnt = 0;
+    newId[blockOf[DFA_DEAD]] = cnt++;
+    for (dfa_state_t s = 0; s < n; s++)
+        if (newId[blockOf[s]] == (dfa_state_t)-1)
+            newId[blockOf[s]] = cnt++;
+    vector<dfa_state_t> newTable(cnt * A, DFA_DEAD);
+    vector<dfa_tag_t> newTags(cnt, DFA_NO_TAG);
+    for (uint32_t b = 0; b < blocks.size(); b++)
+    {
+        dfa_state_t rep = blocks[b][0];
+        dfa_state_t id = newId[b];
+        for (size_t c = 0; c < A; c++)
+            newTable[id * A + c] = newId[blockOf[table[rep * A + c]]];
+        newTags[id] = tags[rep];
+    }
+    startState = newId[blockOf[startState]];
+    table = move(newTable);
+    tags = move(newTags);
+    debug(0) << "DFA: " << cnt << " states after minimization (" << n << " before)" << endl;
+    stateCount = cnt;
+}
+
+/**
+ * @brief 为每个状态计算其自环（停留在该状态的字节集合），集合形状适合时启用向量化的跳过
+ */
+void DeterministicAutomaton::buildSkips()
+{
+    skips.assign(stateCount, skip_kernel_t());
+    for (dfa_state_t s = 1; s < stateCount; s++)
+    {
+        CharSet loop;
+        for (unsigned c = 0; c < DFA_ALPHABET; c++)
+            if (table[s * classCount + byteClass[c]] == s)
+                loop.insert(c);
+        skips[s] = skip_kernel_t::of(loop);
+    }
+}
+
+size_t DeterministicAutomaton::acceleratedStates() const
+{
+    return count_if(skips.begin(), skips.end(), [](const skip_kernel_t &k)
+                    { return k.kind != SKIP_NONE; });
+}
+
+/**
+ * @brief 表驱动的最长匹配，每个字节先查等价类再查转移表，遇到死状态立即停止
+ *
+ * @param begin 待匹配内容的起始位置
+ * @param end   待匹配内容的结束位置
+ * @return size_t 最长匹配的长度，0表示未匹配
+ */
+size_t DeterministicAutomaton::match(const char *begin, const char *end) const
+{
+    size_t matched = 0;
+    dfa_state_t s = startState;
+    const dfa_state_t *tbl = table.data();
+    const uint8_t *cls = byteClass.data();
+    const size_t K = classCount;
+    size_t loops = 0; // 连续停留在同一状态的字节数
+    for (const char *p = begin; p != end; p++)
+    {
+        dfa_state_t t = tbl[s * K + cls[(unsigned char)*p]];
+        if (t == DFA_DEAD)
+            break;
+        loops = t == s ? loops + 1 : 0;
+        s = t;
+        if (tags[s] != DFA_NO_TAG)
+            matched = p - begin + 1;
+        // 沿自环跳过余下的一段输入，途中各位置的接受情况都与当前位置相同
+        // 多数词法单元很短，自环已持续若干字节时才使用向量化的跳过
+        if (loops >= SKIP_MIN_LOOPS && skips[s].kind != SKIP_NONE)
+        {
+            p = skips[s].skip(p + 1, end) - 1;
+            if (tags[s] != DFA_NO_TAG)
+                matched = p - begin + 1;
+        }
+    }
+    return matched;
+}
+
+/**
+ * @brief 带规则优先级的匹配：在所有可匹配的规则中选择标签最小者，并取该规则的最长匹配
+ * 一次扫描即可得到结果，扫描过程中记录当前最优标签及其最后一次被接受的位置
+ * 由于终态标签为其包含规则中的最小者，某位置接受最优规则当且仅当该位置的标签等于最优标签
+ *
+ * @param begin 待匹配内容的起始位置
+ * @param end   待匹配内容的结束位置
+ * @param tag   匹配成功的规则标签，未匹配时为DFA_NO_TAG
+ * @return size_t 匹配长度，0表示未匹配
+ */
+size_t DeterministicAutomaton::match(const char *begin, const char *end, dfa_tag_t &tag) const
+{
+    size_t matched = 0;
+    tag = DFA_NO_TAG;
+    dfa_state_t s = startState;
+    const dfa_state_t *tbl = table.data();
+    const uint8_t *cls = byteClass.data();
+    const size_t K = classCount;
+    size_t loops = 0;
+    for (const char *p = begin; p != end; p++)
+    {
+        dfa_state_t t = tbl[s * K + cls[(unsigned char)*p]];
+        if (t == DFA_DEAD)
+            break;
+        loops = t == s ? loops + 1 : 0;
+        s = t;
+        if (tags[s] <= tag && tags[s] != DFA_NO_TAG)
+        {
+            tag = tags[s];
+            matched = p - begin + 1;
+        }
+        if (loops >= SKIP_MIN_LOOPS && skips[s].kind != SKIP_NONE)
+        {
+            p = skips[s].skip(p + 1, end) - 1;
+            if (tags[s] == tag && tag != DFA_NO_TAG)
+                matched = p - begin + 1;
+        }
+    }
+    return matched;
+}
+
+size_t DeterministicAutomaton::match(const Viewer &view) const
+{
+    if (view.ends())
+        return 0;
+    const char *data = view.data();
+    return match(data + view.getPos(), data + view.size());
+}
+
+size_t DeterministicAutomaton::match(const Viewer &view, dfa_tag_t &tag) const
+{
+    tag = DFA_NO_TAG;
+    if (view.ends())
+        return 0;
+    const char *data = view.data();
+    return match(data + view.getPos(), data + view.size(), tag);
+}
+
+bool DeterministicAutomaton::accepts(Viewer &view, string &result) const
+{
+    size_t len = match(view);
+    if (len == 0)
+        return tags[startState] != DFA_NO_TAG;
+    result.assign(view.data() + view.getPos(), len);
+    view.skip(len);
+    return true;
+}
+
+void DeterministicAutomaton::printStates() const
+{
+    info << "DeterministicAutomaton: States: ";
+    for (dfa_state_t s = 0; s < stateCount; s++)
+    {
+        cout << s;
+        if (s == startState) // 标记开始状态
+            cout << "^";
+        else if (tags[s] != DFA_NO_TAG) // 标记终态
+            cout << "*";
+        else if (s == DFA_DEAD) // 标记死状态
+            cout << "!";
+        cout << " ";
+    }
+    cout << endl;
+}
+
+void DeterministicAutomaton::printTransitions() const
+{
+    info << "DeterministicAutomaton: Transitions:" << endl;
+    auto chr = [](size_t c) -> string
+    {
+        if (c > 0x20 && c < 0x7f)
+            return string(1, (char)c);
+        return "(" + to_string(c) + ")";
+    };
+    for (dfa_state_t s = 1; s < stateCount; s++)
+    {
+        // 将同一目标的连续字节合并为区间输出
+        size_t c = 0;
+        while (c < DFA_ALPHABET)
+        {
+            dfa_state_t to = step(s, c);
+            size_t e = c;
+            while (e + 1 < DFA_ALPHABET && step(s, e + 1) == to)
+                e++;
+            if (to != DFA_DEAD)
+            {
+                cout << "    " << s << " --" << chr(c);
+                if (e > c)
+                    cout << "-" << chr(e);
+                cout << "--> " << to << endl;
+            }
+            c = e + 1;
+        }
+    }
+}
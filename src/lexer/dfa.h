@@ -0,0 +1,140 @@
+/**
+ * @file dfa.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Deterministic Finite Automaton
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 本文件实现由NFA编译得到的确定有限状态自动机（DFA）
+ * 编译过程分为两步：
+ * 1、子集构造：以NFA状态的ε闭包为DFA状态，逐字节等价类计算转移
+ * 2、Hopcroft最小化：按终态标签划分初始等价类，反复分裂直到稳定
+ * 字节等价类：在所有NFA的字符类下行为完全相同的字节归为一类（如[a-z]中除e、x外的字母），
+ * 转移只按类计算和存储，类的个数通常只有几十个
+ * 编译结果为一张 字节->类 的映射表和一张以 (状态, 类) 为下标的扁平转移表，0号状态为死状态
+ * 匹配时每读入一个字节查两次表，不回溯、不递归、不拷贝视图
+ * 自环字节集合形状简单的状态（空白、注释体、标识符等）以向量化的方式一次跳过一段输入，见skip.h
+ *
+ * 多个NFA可以合并编译为一个DFA，每个NFA带有一个标签（规则序号）
+ * DFA终态的标签取其包含的NFA终态中最小的标签，即优先级最高的规则
+ */
+
+#pragma once
+
+#include "nfa.h"
+#include "skip.h"
+#include "utils/view/viewer.h"
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using dfa_state_t = uint32_t;
+using dfa_tag_t = uint32_t;
+
+constexpr dfa_state_t DFA_DEAD = 0;          // 死状态，任何输入都停留在该状态
+constexpr size_t DFA_ALPHABET = 256;         // 字节的取值个数
+constexpr dfa_tag_t DFA_NO_TAG = UINT32_MAX; // 非终态的标签
+
+/**
+ * @brief 确定的有限状态自动机
+ */
+class DeterministicAutomaton
+{
+    dfa_state_t startState = DFA_DEAD;                // 开始状态
+    size_t stateCount = 1;                            // 状态数（含死状态）
+    size_t classCount = 1;                            // 字节等价类的个数
+    std::array<uint8_t, DFA_ALPHABET> byteClass = {}; // 字节 -> 等价类
+    std::vector<dfa_state_t> table;                   // 转移表，行优先，table[s * classCount + byteClass[c]]
+    std::vector<dfa_tag_t> tags;                      // 终态标签，非终态为DFA_NO_TAG
+    std::vector<skip_kernel_t> skips;                 // 各状态自环的加速方式
+
+    void determinize(const std::vector<const FiniteAutomaton *> &nfas, const std::vector<dfa_tag_t> &nfaTags); // 子集构造
+    void minimize();                                                                                            // Hopcroft最小化
+    void buildSkips();                                                                                          // 识别可加速的自环
+
+public:
+    DeterministicAutomaton() : table(1, DFA_DEAD), tags(1, DFA_NO_TAG), skips(1) {}
+    DeterministicAutomaton(const FiniteAutomaton &nfa)
+    {
+        determinize({&nfa}, {0});
+        minimize();
+        buildSkips();
+    }
+    DeterministicAutomaton(const std::vector<const FiniteAutomaton *> &nfas, const std::vector<dfa_tag_t> &nfaTags)
+    {
+        determinize(nfas, nfaTags);
+        minimize();
+        buildSkips();
+    }
+    // 由已编译的等价类映射和转移表直接构造（如从预编译文件中加载）
+    DeterministicAutomaton(dfa_state_t start, const std::array<uint8_t, DFA_ALPHABET> &classes,
+                           std::vector<dfa_state_t> table, std::vector<dfa_tag_t> tags)
+        : startState(start), stateCount(tags.size()), byteClass(classes), table(std::move(table)), tags(std::move(tags))
+    {
+        classCount = this->table.size() / stateCount;
+        buildSkips();
+    }
+
+    dfa_state_t step(dfa_state_t s, char c) const
+    {
+        return table[s * classCount + byteClass[(unsigned char)c]];
+    }
+
+    bool isFinal(dfa_state_t s) const
+    {
+        return tags[s] != DFA_NO_TAG;
+    }
+
+    dfa_tag_t getTag(dfa_state_t s) const
+    {
+        return tags[s];
+    }
+
+    dfa_state_t getStartState() const
+    {
+        return startState;
+    }
+
+    size_t size() const
+    {
+        return stateCount;
+    }
+
+    size_t getClassCount() const
+    {
+        return classCount;
+    }
+
+    const std::array<uint8_t, DFA_ALPHABET> &getByteClasses() const
+    {
+        return byteClass;
+    }
+
+    const std::vector<dfa_state_t> &getTable() const
+    {
+        return table;
+    }
+
+    const std::vector<dfa_tag_t> &getTags() const
+    {
+        return tags;
+    }
+
+    size_t acceleratedStates() const; // 自环可加速的状态数
+
+    size_t match(const char *begin, const char *end) const;                 // 返回从begin开始的最长匹配长度，0表示未匹配
+    size_t match(const char *begin, const char *end, dfa_tag_t &tag) const; // 按标签优先级匹配，返回匹配长度及规则标签
+    size_t match(const Viewer &view) const;                                 // 从视图当前位置开始匹配，不移动视图
+    size_t match(const Viewer &view, dfa_tag_t &tag) const;                 // 同上，并返回匹配的规则标签
+    bool accepts(Viewer &view, std::string &result) const;                  // 与FiniteAutomaton::accepts语义一致
+    void printStates() const;                                               // 打印状态集合
+    void printTransitions() const;                                          // 打印转移函数
+};
+
+using DFA = DeterministicAutomaton;
@@ -0,0 +1,102 @@
+/**
+ * @file flat_nfa.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Flattened NFA for Determinization
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "flat_nfa.h"
+#include "utils/log.h"
+
+#include <set>
+#include <algorithm>
+
+using namespace std;
+
+FlatNFA::FlatNFA(const vector<const FiniteAutomaton *> &nfas, const vector<dfa_tag_t> &nfaTags)
+{
+    assert(nfas.size() == nfaTags.size(), "DFA: Each NFA should have a tag!");
+    size_t offset = 0;
+    set<CharSet> classes; // 出现过的所有字符类
+    for (size_t i = 0; i < nfas.size(); i++)
+    {
+        const FiniteAutomaton &nfa = *nfas[i];
+        size_t n = nfa.getStates().size();
+        eps.resize(offset + n);
+        edges.resize(offset + n);
+        tags.resize(offset + n, DFA_NO_TAG);
+        starts.push_back(offset + nfa.getStartState());
+        for (auto &state : nfa.getStates())
+            if (state.isFinal)
+                tags[offset + state.id] = nfaTags[i];
+        auto &trans = nfa.getTransitions();
+        for (state_id_t from = 0; from < trans.size(); from++)
+        {
+            for (auto to : trans[from].eps)
+                eps[offset + from].push_back(offset + to);
+            for (auto &edge : trans[from].edges)
+            {
+                edges[offset + from].push_back(make_pair(edge.first, offset + edge.second));
+                classes.insert(edge.first);
+            }
+        }
+        offset += n;
+    }
+    stamp.assign(offset, 0);
+    // 逐个字符类细分字节的划分：两个字节属于同一类，当且仅当它们属于完全相同的字符类
+    for (auto &cls : classes)
+    {
+        vector<int> renum(classCount * 2, -1);
+        size_t cnt = 0;
+        for (size_t c = 0; c < DFA_ALPHABET; c++)
+        {
+            int &id = renum[byteClass[c] * 2 + cls.contains(c)];
+            if (id < 0)
+                id = cnt++;
+            byteClass[c] = id;
+        }
+        classCount = cnt;
+    }
+    for (auto &out : edges)
+    {
+        for (auto &edge : out)
+        {
+            CharSet ids;
+            edge.first.foreach ([&](unsigned c)
+                                { ids.insert(byteClass[c]); });
+            edge.first = ids;
+        }
+    }
+}
+
+nfa_set_t FlatNFA::closure(const vector<state_id_t> &seeds)
+{
+    curStamp++;
+    nfa_set_t res;
+    vector<state_id_t> stk;
+    for (auto s : seeds)
+    {
+        if (stamp[s] == curStamp)
+            continue;
+        stamp[s] = curStamp;
+        stk.push_back(s);
+    }
+    while (!stk.empty())
+    {
+        state_id_t s = stk.back();
+        stk.pop_back();
+        res.push_back(s);
+        for (auto t : eps[s])
+        {
+            if (stamp[t] == curStamp)
+                continue;
+            stamp[t] = curStamp;
+            stk.push_back(t);
+        }
+    }
+    sort(res.begin(), res.end());
+    return res;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file flat_nfa.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Flattened NFA for Determinization
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include "nfa.h"
+#include "dfa.h"
+
+#include <array>
+#include <vector>
+
+using nfa_set_t = std::vector<state_id_t>; // 有序的NFA状态集合
+
+/**
+ * @brief 将若干NFA整理为一个邻接表形式的NFA，便于子集构造时快速遍历
+ * 第i个NFA的状态编号整体偏移其前所有NFA的状态数，其终态带有标签nfaTags[i]
+ * 同时计算所有字符类共同的字节等价类，字符转移的标号由字节集合转换为等价类集合
+ * 完整的子集构造（DFA）与按需的子集构造（LazyDFA）共用
+ */
+struct FlatNFA
+{
+    std::vector<std::vector<state_id_t>> eps;                       // ε转移
+    std::vector<std::vector<std::pair<CharSet, state_id_t>>> edges; // 字符转移，标号为等价类集合
+    std::vector<dfa_tag_t> tags;                                    // 终态标签
+    std::vector<state_id_t> starts;                                 // 各NFA的开始状态
+    std::vector<size_t> stamp;                                      // 闭包计算时的访问标记
+    size_t curStamp = 0;
+    std::array<uint8_t, DFA_ALPHABET> byteClass = {};               // 字节 -> 等价类
+    size_t classCount = 1;
+
+    FlatNFA(const std::vector<const FiniteAutomaton *> &nfas, const std::vector<dfa_tag_t> &nfaTags);
+    // 计算seeds的ε闭包，结果有序且无重复
+    nfa_set_t closure(const std::vector<state_id_t> &seeds);
+    size_t size() const { return tags.size(); }
+};
@@ -0,0 +1,216 @@
+/**
+ * @file lazy_dfa.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Lazily Determinized Finite Automaton
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lazy_dfa.h"
+#include "flat_nfa.h"
+#include "utils/log.h"
+
+#include <bit>
+#include <algorithm>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+LazyDeterministicAutomaton::LazyDeterministicAutomaton(
+    const vector<const FiniteAutomaton *> &nfas, const vector<dfa_tag_t> &nfaTags, size_t capacity)
+    : capacity(max<size_t>(capacity, 3))
+{
+    FlatNFA flat(nfas, nfaTags);
+    auto p = make_shared<program_t>();
+    p->stateCount = flat.size();
+    p->words = (flat.size() + 63) / 64;
+    p->classCount = flat.classCount;
+    p->byteClass = flat.byteClass;
+    p->edges = move(flat.edges);
+    p->tags = flat.tags;
+    p->closures.resize(flat.size());
+    for (state_id_t s = 0; s < flat.size(); s++)
+        p->closures[s] = flat.closure({s});
+    p->start.assign(p->words, 0);
+    for (auto s : flat.closure(flat.starts))
+        p->start[s >> 6] |= uint64_t(1) << (s & 63);
+    prog = p;
+    flush();
+    stats = lazy_dfa_stats_t();
+    debug(0) << "LazyDFA: " << p->stateCount << " NFA states, " << p->classCount << " byte classes" << endl;
+}
+
+// 清空缓存，只保留死状态和开始状态
+void LazyDeterministicAutomaton::flush() const
+{
+    const program_t &p = *prog;
+    sets.clear();
+    trans.clear();
+    tags.clear();
+    index.clear();
+    scratch.assign(p.words, 0);
+    intern(scratch.data());
+    fill(trans.begin(), trans.end(), DFA_DEAD); // 死状态的转移都回到自身
+    startState = intern(p.start.data());
+    stats.flushes++;
+}
+
+// 查找状态集合对应的缓存状态，不存在时加入缓存（不检查容量）
+dfa_state_t LazyDeterministicAutomaton::intern(const uint64_t *set) const
+{
+    const program_t &p = *prog;
+    string key((const char *)set, p.words * sizeof(uint64_t));
+    auto it = index.find(key);
+    if (it != index.end())
+        return it->second;
+    dfa_state_t id = tags.size();
+    sets.insert(sets.end(), set, set + p.words);
+    trans.resize(trans.size() + p.classCount, LAZY_DFA_UNKNOWN);
+    tags.push_back(tagOf(set));
+    index.emplace(move(key), id);
+    return id;
+}
+
+// 位并行的NFA单步：from中各状态经等价类k的后继的ε闭包之并
+void LazyDeterministicAutomaton::stepSet(const uint64_t *from, size_t k, uint64_t *to) const
+{
+    const program_t &p = *prog;
+    fill(to, to + p.words, 0);
+    for (size_t w = 0; w < p.words; w++)
+    {
+        for (uint64_t bits = from[w]; bits != 0; bits &= bits - 1)
+        {
+            state_id_t s = w * 64 + countr_zero(bits);
+            for (auto &edge : p.edges[s])
+            {
+                if (!edge.first.contains(k))
+                    continue;
+                for (auto t : p.closures[edge.second])
+                    to[t >> 6] |= uint64_t(1) << (t & 63);
+            }
+        }
+    }
+}
+
+dfa_tag_t LazyDeterministicAutomaton::tagOf(const uint64_t *set) const
+{
+    const program_t &p = *prog;
+    dfa_tag_t tag = DFA_NO_TAG;
+    for (size_t w = 0; w < p.words; w++)
+        for (uint64_t bits = set[w]; bits != 0; bits &= bits - 1)
+            tag = min(tag, p.tags[w * 64 + countr_zero(bits)]); // 取优先级最高（标签最小）的规则
+    return tag;
+}
+
+/**
+ * @brief 计算缓存状态s经等价类k的转移
+ * 缓存已满时先清空缓存，此时s不再有效，只返回目标状态而不记录这条转移
+ */
+dfa_state_t LazyDeterministicAutomaton::compute(dfa_state_t s, size_t k) const
+{
+    const program_t &p = *prog;
+    stats.misses++;
+    stepSet(sets.data() + s * p.words, k, scratch.data());
+    string key((const char *)scratch.data(), p.words * sizeof(uint64_t));
+    auto it = index.find(key);
+    if (it != index.end())
+    {
+        trans[s * p.classCount + k] = it->second;
+        return it->second;
+    }
+    if (tags.size() >= capacity)
+    {
+        vector<uint64_t> target = scratch; // flush会重置scratch
+        flush();
+        return intern(target.data());
+    }
+    dfa_state_t t = intern(scratch.data());
+    trans[s * p.classCount + k] = t;
+    return t;
+}
+
+/**
+ * @brief 匹配主循环
+ *
+ * @param priority 是否按标签优先级匹配（见DFA::match），否则取任意规则的最长匹配
+ */
+size_t LazyDeterministicAutomaton::run(const char *begin, const char *end, dfa_tag_t &tag, bool priority) const
+{
+    size_t matched = 0;
+    tag = DFA_NO_TAG;
+    if (!prog)
+        return 0;
+    const program_t &p = *prog;
+    const uint8_t *cls = p.byteClass.data();
+    const size_t K = p.classCount;
+    auto accept = [&](dfa_tag_t t, const char *at)
+    {
+        if (t == DFA_NO_TAG || (priority && t > tag))
+            return;
+        tag = priority ? t : min(tag, t);
+        matched = at - begin + 1;
+    };
+    size_t flushes = stats.flushes;
+    dfa_state_t s = startState;
+    const char *c = begin;
+    for (; c != end; c++)
+    {
+        size_t k = cls[(unsigned char)*c];
+        dfa_state_t t = trans[s * K + k];
+        if (t == LAZY_DFA_UNKNOWN)
+        {
+            if (stats.flushes - flushes >= LAZY_DFA_MAX_FLUSHES)
+                break; // 缓存频繁清空，改用NFA模拟
+            t = compute(s, k);
+        }
+        s = t;
+        if (s == DFA_DEAD)
+            return matched;
+        accept(tags[s], c);
+    }
+    if (c == end)
+        return matched;
+    stats.fallbacks++;
+    vector<uint64_t> cur(sets.begin() + s * p.words, sets.begin() + (s + 1) * p.words), next(p.words);
+    for (; c != end; c++)
+    {
+        stepSet(cur.data(), cls[(unsigned char)*c], next.data());
+        if (all_of(next.begin(), next.end(), [](uint64_t w)
+                   { return w == 0; }))
+            break;
+        accept(tagOf(next.data()), c);
+        swap(cur, next);
+    }
+    return matched;
+}
+
+size_t LazyDeterministicAutomaton::match(const char *begin, const char *end) const
+{
+    dfa_tag_t tag;
+    return run(begin, end, tag, false);
+}
+
+size_t LazyDeterministicAutomaton::match(const char *begin, const char *end, dfa_tag_t &tag) const
+{
+    return run(begin, end, tag, true);
+}
+
+size_t LazyDeterministicAutomaton::match(const Viewer &view) const
+{
+    if (view.ends())
+        return 0;
+    const char *data = view.data();
+    return match(data + view.getPos(), data + view.size());
+}
+
+size_t LazyDeterministicAutomaton::match(const Viewer &view, dfa_tag_t &tag) const
+{
+    tag = DFA_NO_TAG;
+    if (view.ends())
+        return 0;
+    const char *data = view.data();
+    return match(data + view.getPos(), data + view.size(), tag);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file lazy_dfa.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Lazily Determinized Finite Automaton
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 按需确定化的有限状态自动机
+ * 不预先做完整的子集构造，而是在匹配过程中才计算实际走到的DFA状态及其转移，并将其缓存：
+ * 1、DFA状态即NFA状态集合，以位图表示；转移按字节等价类计算，与DFA相同
+ * 2、缓存的状态数有上限，缓存满时整体清空，从当前状态重新开始建立
+ * 3、若一次匹配中缓存被清空了LAZY_DFA_MAX_FLUSHES次（输入走到的状态过多，缓存形同虚设），
+ *    该次匹配余下的部分改用位并行的NFA模拟：每读入一个字节，对当前状态集合中的各状态按字或上其后继的ε闭包
+ * 因此热路径上与DFA一样每个字节只查一次表，最坏情况下每个字节的代价也只与NFA的大小成正比，内存不超过缓存容量
+ *
+ * 缓存在匹配时被修改，同一个对象不能在多个线程中同时使用；
+ * 拷贝得到的对象共享只读的NFA部分，各自持有缓存，可以分别在不同线程中使用
+ */
+
+#pragma once
+
+#include "nfa.h"
+#include "dfa.h"
+#include "utils/view/viewer.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+constexpr size_t LAZY_DFA_CAPACITY = 1024;       // 默认缓存的最大状态数
+constexpr size_t LAZY_DFA_MAX_FLUSHES = 2;       // 单次匹配中缓存清空的次数达到该值后改用NFA模拟
+constexpr dfa_state_t LAZY_DFA_UNKNOWN = UINT32_MAX; // 尚未计算的转移
+
+struct lazy_dfa_stats_t
+{
+    size_t misses = 0;    // 计算的转移数
+    size_t flushes = 0;   // 缓存清空次数
+    size_t fallbacks = 0; // 改用NFA模拟的匹配次数
+};
+
+class LazyDeterministicAutomaton
+{
+    // 由NFA得到的只读部分，拷贝之间共享
+    struct program_t
+    {
+        size_t stateCount = 0;                                       // NFA状态数
+        size_t words = 0;                                            // 状态集合位图的字数
+        size_t classCount = 1;                                       // 字节等价类的个数
+        std::array<uint8_t, DFA_ALPHABET> byteClass = {};            // 字节 -> 等价类
+        std::vector<std::vector<std::pair<CharSet, state_id_t>>> edges; // 字符转移，标号为等价类集合
+        std::vector<std::vector<state_id_t>> closures;               // 各NFA状态的ε闭包
+        std::vector<dfa_tag_t> tags;                                 // NFA状态的终态标签
+        std::vector<uint64_t> start;                                 // 开始状态集合
+    };
+    std::shared_ptr<const program_t> prog;
+    size_t capacity = LAZY_DFA_CAPACITY;
+
+    // 缓存，第i个状态的NFA状态集合为sets[i * words ...]，转移为trans[i * classCount + k]，0号状态为死状态
+    mutable std::vector<uint64_t> sets;
+    mutable std::vector<dfa_state_t> trans;
+    mutable std::vector<dfa_tag_t> tags;
+    mutable std::unordered_map<std::string, dfa_state_t> index; // 状态集合位图 -> 缓存状态
+    mutable dfa_state_t startState = DFA_DEAD;
+    mutable std::vector<uint64_t> scratch;
+    mutable lazy_dfa_stats_t stats;
+
+    void flush() const;
+    dfa_state_t intern(const uint64_t *set) const;
+    dfa_state_t compute(dfa_state_t s, size_t k) const;
+    void stepSet(const uint64_t *from, size_t k, uint64_t *to) const;
+    dfa_tag_t tagOf(const uint64_t *set) const;
+    size_t run(const char *begin, const char *end, dfa_tag_t &tag, bool priority) const;
+
+public:
+    LazyDeterministicAutomaton() = default;
+    LazyDeterministicAutomaton(const FiniteAutomaton &nfa, size_t capacity = LAZY_DFA_CAPACITY)
+        : LazyDeterministicAutomaton({&nfa}, {0}, capacity) {}
+    LazyDeterministicAutomaton(const std::vector<const FiniteAutomaton *> &nfas, const std::vector<dfa_tag_t> &nfaTags,
+                               size_t capacity = LAZY_DFA_CAPACITY);
+
+    size_t match(const char *begin, const char *end) const;                 // 返回从begin开始的最长匹配长度，0表示未匹配
+    size_t match(const char *begin, const char *end, dfa_tag_t &tag) const; // 按标签优先级匹配，返回匹配长度及规则标签
+    size_t match(const Viewer &view) const;                                 // 从视图当前位置开始匹配，不移动视图
+    size_t match(const Viewer &view, dfa_tag_t &tag) const;                 // 同上，并返回匹配的规则标签
+
+    size_t getCapacity() const { return capacity; }
+    size_t getClassCount() const { return prog ? prog->classCount : 1; }
+    size_t cachedStates() const { return tags.size(); }
+    const lazy_dfa_stats_t &getStats() const { return stats; }
+};
+
+using LazyDFA = LazyDeterministicAutomaton;
@@ -17,7 +17,10 @@
 #include "utils/view/ctx_view.h"
 #include "utils/view/wrd_view.h"
 
+#include <atomic>
+#include <thread>
 #include <sstream>
+#include <algorithm>
 
 using namespace std;
 
@@ -38,7 +41,11 @@ void Lexer::addTokenType(string typeName, string regExp)
     RegexpParser regParser(regExp);
     FiniteAutomaton nfa = regParser.parse();
     typeOrder.push_back(type);
+    typeIds[type] = internTokType(type);
     faMap[type].push_back(nfa);
+    dfaMap[type].push_back(DFA(nfa));
+    if (combined)
+        compileCombined();
     debug(1) << "Add token type: " << type << " with regExp: " << regExp << endl;
 }
 
@@ -54,101 +61,311 @@ void Lexer::addIgnoredType(string typeName)
     error << "Type " << typeName << " not found!" << endl;
 }
 
-string &zTrim(string &s)
+/**
+ * @brief 将所有模式合并编译为一个自动机
+ * 每个类型以其在typeOrder中首次出现的次序作为标签，标签越小优先级越高
+ * 合并自动机一次扫描得到的结果与逐类型匹配（类型优先，同类型取最长）完全一致
+ */
+void Lexer::compileCombined()
 {
-    while (!s.empty() && s.back() == 0)
+    info << "Lexer: Compiling combined automaton..." << endl;
+    tagTypes.clear();
+    vector<const FiniteAutomaton *> nfas;
+    vector<dfa_tag_t> tags;
+    for (auto &typ : typeOrder)
     {
-        s.pop_back();
+        if (find(tagTypes.begin(), tagTypes.end(), typ) != tagTypes.end())
+            continue;
+        dfa_tag_t tag = tagTypes.size();
+        tagTypes.push_back(typ);
+        for (auto &nfa : faMap.at(typ))
+        {
+            nfas.push_back(&nfa);
+            tags.push_back(tag);
+        }
     }
-    return s;
+    if (lazy)
+    {
+        lazyDFA = LazyDFA(nfas, tags, lazyCapacity);
+        info << "Lexer: Combined automaton is determinized lazily, " << lazyDFA.getClassCount()
+             << " byte classes, caching at most " << lazyDFA.getCapacity() << " states" << endl;
+        return;
+    }
+    combinedDFA = DFA(nfas, tags);
+    info << "Lexer: Combined automaton has " << combinedDFA.size() << " states, "
+         << combinedDFA.getClassCount() << " byte classes" << endl;
 }
 
-string &visualize(string &s)
+Lexer::Lexer(const DFA &dfa, const vector<token_type_t> &types, const set<token_type_t, type_less> &ignored)
+    : ignoredTypes(ignored), typeOrder(types), combined(true), combinedDFA(dfa), tagTypes(types)
 {
-    // 将字符串中的不可见字符转换为可见字符
-    // 比如将换行符转换为\n，将制表符转换为\t
-    for (int i = 0; i < s.length(); i++)
+    for (auto &type : types)
+        typeIds[type] = internTokType(type);
+}
+
+void Lexer::useCombinedAutomaton(bool enable)
+{
+    if (!enable && faMap.empty())
     {
-        if (s[i] == '\n')
-        {
-            s.replace(i, 1, "\\n");
-        }
-        else if (s[i] == '\t')
-        {
-            s.replace(i, 1, "\\t");
-        }
-        else if (s[i] == '\r')
-        {
-            s.replace(i, 1, "\\r");
-        }
-        else if (s[i] == '\v')
+        warn << "Lexer: No pattern available, keep using combined automaton." << endl;
+        return;
+    }
+    if (enable && !combined)
+        compileCombined();
+    combined = enable;
+}
+
+void Lexer::useLazyAutomaton(bool enable, size_t capacity)
+{
+    if (faMap.empty())
+    {
+        warn << "Lexer: No pattern available, lazy automaton needs the NFAs." << endl;
+        return;
+    }
+    bool rebuild = combined && (lazy != enable || (enable && capacity != lazyCapacity));
+    lazy = enable;
+    lazyCapacity = capacity;
+    if (enable && !combined)
+    {
+        combined = true;
+        rebuild = true;
+    }
+    if (rebuild)
+        compileCombined();
+}
+
+/**
+ * @brief 从视图当前位置匹配一个词法单元
+ *
+ * @param view 源代码视图
+ * @param type 匹配到的词法单元类型
+ * @return size_t 匹配长度，0表示匹配失败
+ */
+size_t Lexer::matchToken(const Viewer &view, token_type_t &type) const
+{
+    return matchToken(view, type, lazyDFA);
+}
+
+// 同上，按需确定化时使用给定的自动机（其缓存不能在线程间共享，并行扫描时各线程使用自己的拷贝）
+size_t Lexer::matchToken(const Viewer &view, token_type_t &type, const LazyDFA &lazyAuto) const
+{
+    if (combined)
+    {
+        dfa_tag_t tag;
+        size_t len = lazy ? lazyAuto.match(view, tag) : combinedDFA.match(view, tag);
+        if (len > 0)
+            type = tagTypes[tag];
+        return len;
+    }
+    size_t matchedLen = 0;
+    for (auto &typ : typeOrder) // 按序遍历所有的状态自动机
+    {
+        const auto &dfaVec = dfaMap.at(typ);
+        for (auto &dfa : dfaVec)
         {
-            s.replace(i, 1, "\\v");
+            size_t len = dfa.match(view);
+            if (len > matchedLen) // 同类型的自动机取匹配的最长词法单元
+            {
+                matchedLen = len;
+                type = typ;
+            }
         }
-        else if (s[i] == '\f')
+        if (matchedLen > 0) // 按照顺序，一旦有某种类型的自动机匹配成功，就不再匹配其他类型的自动机
+            break;
+    }
+    return matchedLen;
+}
+
+// 报告视图当前位置匹配失败，并打印出错位置的上下文
+void Lexer::reportFailure(ContextViewer &view) const
+{
+    auto lc = view.getCurLineCol();
+    error << "Tokenize failed at <" << lc.first << ", " << lc.second << ">" << endl;
+    view.printContext();
+}
+
+/**
+ * @brief 从视图当前位置取出下一个词法单元，跳过被忽略的类型（空白和注释），无法匹配时报错并跳到下一行
+ *
+ * @param view 源代码视图，取出后游标位于该词法单元之后
+ * @param type 词法单元的类型编号
+ * @param offset 词法单元在源文本中的起始位置
+ * @param length 词法单元的长度
+ * @return true 取到了词法单元
+ * @return false 已到达源文本结尾
+ */
+bool Lexer::next(ContextViewer &view, tok_id_t &type, size_t &offset, size_t &length) const
+{
+    while (!view.ends())
+    {
+        token_type_t matchedType;
+        size_t matchedLen = matchToken(view, matchedType);
+        if (matchedLen == 0)
         {
-            s.replace(i, 1, "\\f");
+            reportFailure(view);
+            view.skipToNextLine();
+            continue;
         }
+        size_t pos = view.getPos();
+        view.skip(matchedLen);
+        debug(0) << format("Matched: $ <$>", view.getView().substr(pos, matchedLen), matchedLen) << endl;
+        if (_find(ignoredTypes, matchedType))
+            continue;
+        type = typeIds.at(matchedType);
+        offset = pos;
+        length = matchedLen;
+        return true;
     }
-    return s;
+    return false;
 }
 
-vector<token> Lexer::tokenize(const Viewer &viewer) const
+/**
+ * @brief 将源代码切分为紧凑的词法单元序列
+ * 词法单元的值和行列号不在此处计算，而是在使用时由TokenStream从源文本中获取
+ */
+TokenStream Lexer::scan(const Viewer &viewer) const
 {
     info << "Tokenizing... " << endl;
-    vector<token> tokens;
-    ContextViewer vCode(viewer);
-    while (!vCode.ends())
+    TokenStream tokens(viewer);
+    ContextViewer vCode(tokens.getSource());
+    tok_id_t type;
+    size_t offset, length;
+    while (next(vCode, type, offset, length))
+        tokens.push(type, offset, length);
+    return tokens;
+}
+
+struct Lexer::lex_chunk_t
+{
+    size_t begin = 0, end = 0;        // 分块的区间，起点总在行首
+    size_t stop = 0;                  // 扫描停止的位置，即最后一次匹配之后，可能越过end
+    std::vector<size_t> starts;       // 每次匹配开始的位置（含忽略的类型和匹配失败），升序
+    std::vector<token_span> spans;    // 未被忽略的词法单元
+    std::vector<size_t> failures;     // 匹配失败的位置
+};
+
+// 从视图当前位置匹配一次并记录到out中，与next的一次循环相同，但匹配失败时只记录而不报告
+void Lexer::scanStep(Viewer &view, const LazyDFA &lazyAuto, lex_chunk_t &out) const
+{
+    size_t pos = view.getPos();
+    token_type_t type;
+    size_t len = matchToken(view, type, lazyAuto);
+    out.starts.push_back(pos);
+    if (len == 0)
     {
-        bool matched = false;
-        string matchedToken;
-        token_type_t matchedType;
-        Viewer matchedView = vCode;
-        for (auto typ : typeOrder) // 按序遍历所有的状态自动机
+        out.failures.push_back(pos);
+        size_t nl = view.getView().find('\n', pos); // 同ContextViewer::skipToNextLine
+        view.jump(nl == string_view::npos ? view.size() : nl + 1);
+        return;
+    }
+    view.skip(len);
+    if (!_find(ignoredTypes, type))
+        out.spans.push_back({typeIds.at(type), (uint32_t)pos, (uint32_t)len});
+}
+
+/**
+ * @brief 并行扫描
+ * 词法分析器没有模式，从某个位置开始的扫描结果只取决于该位置，因此：
+ * 1、在行首将源文本切分为若干分块，各线程假定分块起点恰为某个词法单元的起点，推测地扫描各个分块
+ * 2、按顺序拼接：若前一分块实际停止的位置就是本分块的起点，推测成立，直接采用整个分块的结果；
+ *    否则（前一分块的最后一个词法单元越过了接缝，如跨行的块注释或字符串），从实际位置开始重新扫描，
+ *    直到到达本分块推测结果中的某个匹配起点，此后两者必然一致，采用推测结果的余下部分
+ * 推测扫描中的匹配失败只在被采用时才报告，报告的内容和顺序与scan相同
+ */
+TokenStream Lexer::scanParallel(const Viewer &viewer, size_t threads) const
+{
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+    size_t n = viewer.size();
+    size_t chunkCount = min(threads * 4, n / LEX_PARALLEL_MIN_CHUNK);
+    if (threads < 2 || chunkCount < 2)
+        return scan(viewer);
+    info << "Tokenizing in parallel (" << threads << " threads, " << chunkCount << " chunks)... " << endl;
+    TokenStream tokens(viewer);
+    ContextViewer source = tokens.getSource();
+    string_view text = source.getView();
+    vector<lex_chunk_t> chunks(chunkCount);
+    size_t begin = 0;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        size_t end = n;
+        if (i + 1 < chunkCount)
         {
-            const auto &faVec = faMap.at(typ);
-            for (auto nfa : faVec)
-            {
-                Viewer vTmp = vCode;
-                string matchResult;
-                if (nfa.accepts(vTmp, matchResult))
-                {
-                    if (matchResult.length() > matchedToken.length()) // 同类型的自动机取匹配的最长词法单元
-                    {
-                        matchedToken = matchResult;
-                        matchedType = typ;
-                        matchedView = vTmp;
-                        matched = true;
-                    }
-                }
-            }
-            if (matched) // 按照顺序，一旦有某种类型的自动机匹配成功，就不再匹配其他类型的自动机
-                break;
+            size_t nl = text.find('\n', max(begin, n * (i + 1) / chunkCount));
+            end = nl == string_view::npos ? n : nl + 1;
         }
-        if (matched)
+        chunks[i].begin = begin;
+        chunks[i].end = end;
+        begin = end;
+    }
+
+    atomic<size_t> nextChunk = 0;
+    auto worker = [&]()
+    {
+        LazyDFA local = lazyDFA;
+        Viewer view = source;
+        for (size_t i; (i = nextChunk++) < chunkCount;)
+        {
+            lex_chunk_t &c = chunks[i];
+            view.jump(c.begin);
+            while (view.getPos() < c.end)
+                scanStep(view, local, c);
+            c.stop = view.getPos();
+        }
+    };
+    vector<thread> pool;
+    for (size_t t = 1; t < threads; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool)
+        t.join();
+
+    tokens.reserve(n / 4);
+    // 采用c中从位置from开始的结果
+    auto accept = [&](const lex_chunk_t &c, size_t from)
+    {
+        auto s = lower_bound(c.spans.begin(), c.spans.end(), from, [](const token_span &t, size_t p)
+                             { return t.offset < p; });
+        auto f = lower_bound(c.failures.begin(), c.failures.end(), from);
+        for (; s != c.spans.end(); s++)
         {
-            matchedToken = zTrim(matchedToken);     // 补丁：去掉末尾的空字符，产生原因未知
-            matchedToken = visualize(matchedToken); // 补丁：可视化字符串
-            vCode = matchedView;
-            if (!_find(ignoredTypes, matchedType))
+            for (; f != c.failures.end() && *f < s->offset; f++)
             {
-                // 忽略空白和注释，其他的都作为词法单元
-                size_t line, col;
-                tie(line, col) = vCode.getCurLineCol();
-                tokens.push_back(
-                    token(matchedType, matchedToken, line, col));
+                source.jump(*f);
+                reportFailure(source);
             }
-            debug(0) << format("Matched: $ <$>", matchedToken, matchedToken.size()) << endl;
+            tokens.push(s->type, s->offset, s->length);
+        }
+        for (; f != c.failures.end(); f++)
+        {
+            source.jump(*f);
+            reportFailure(source);
+        }
+    };
+    size_t pos = 0, relexed = 0;
+    Viewer view = source;
+    for (auto &c : chunks)
+    {
+        if (pos == c.begin)
+        {
+            accept(c, pos);
+            pos = c.stop;
+            continue;
         }
-        else
+        lex_chunk_t fix;
+        view.jump(pos);
+        while (view.getPos() < c.end && !binary_search(c.starts.begin(), c.starts.end(), view.getPos()))
+            scanStep(view, lazyDFA, fix);
+        relexed += view.getPos() - pos;
+        accept(fix, pos);
+        pos = view.getPos();
+        if (binary_search(c.starts.begin(), c.starts.end(), pos))
         {
-            auto lc = vCode.getCurLineCol();
-            error << "Tokenize failed at <" << lc.first << ", " << lc.second << ">" << endl;
-            // 打印出错位置的上下文
-            vCode.printContext();
-            vCode.skipToNextLine();
+            accept(c, pos);
+            pos = c.stop;
         }
     }
+    debug(0) << format("Parallel scan: $ tokens, $ bytes re-lexed at seams", tokens.size(), relexed) << endl;
     return tokens;
 }
 
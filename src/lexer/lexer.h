@@ -11,7 +11,10 @@
 #pragma once
 
 #include "nfa.h"
+#include "dfa.h"
+#include "lazy_dfa.h"
 #include "common/token.h"
+#include "common/tok_stream.h"
 #include "utils/view/viewer.h"
 #include "utils/meta.h"
 
@@ -19,11 +22,29 @@
 #include <string>
 #include <vector>
 
+constexpr size_t LEX_PARALLEL_MIN_CHUNK = 1 << 16; // 并行扫描时每个分块的最小字节数
+
 class Lexer
 {
     std::set<token_type_t, type_less> ignoredTypes;
     std::vector<token_type_t> typeOrder;                                   // 词法单元类型顺序
     std::map<token_type_t, std::vector<FiniteAutomaton>, type_less> faMap; // 状态自动机对照表
+    std::map<token_type_t, std::vector<DFA>, type_less> dfaMap;            // 编译后的确定状态自动机对照表
+    bool combined = false;                                                 // 是否使用合并的多模式自动机
+    DFA combinedDFA;                                                       // 合并所有模式的自动机，终态标签为类型的优先级
+    bool lazy = false;                                                     // 合并自动机是否按需确定化
+    LazyDFA lazyDFA;                                                       // 按需确定化的合并自动机，标签同combinedDFA
+    size_t lazyCapacity = LAZY_DFA_CAPACITY;                               // 按需确定化时缓存的最大状态数
+    std::vector<token_type_t> tagTypes;                                    // 合并自动机的标签 -> 词法单元类型
+    std::map<token_type_t, tok_id_t, type_less> typeIds;                   // 词法单元类型 -> 类型编号
+
+    struct lex_chunk_t; // 并行扫描中一个分块的结果
+
+    void compileCombined();
+    size_t matchToken(const Viewer &view, token_type_t &type) const;
+    size_t matchToken(const Viewer &view, token_type_t &type, const LazyDFA &lazyAuto) const;
+    void reportFailure(ContextViewer &view) const;
+    void scanStep(Viewer &view, const LazyDFA &lazyAuto, lex_chunk_t &out) const;
 
 public:
     Lexer() {}
@@ -36,10 +57,27 @@ public:
         MetaParser parser = MetaParser::fromFile(metaFile);
         configLexer(parser["PATTERN"], parser["IGNORED"]);
     }
+    // 由已编译的合并自动机直接构造，只支持合并自动机模式
+    Lexer(const DFA &dfa, const std::vector<token_type_t> &types, const std::set<token_type_t, type_less> &ignored);
     void configLexer(const meta_t &pattern, const meta_t &ignored = meta_null);
     void addTokenType(std::string typeName, std::string regExp);
     void addIgnoredType(std::string typeName);
-    std::vector<token> tokenize(const Viewer &viewer) const;
+    void useCombinedAutomaton(bool enable = true);
+    // 合并自动机改为扫描时按需确定化，缓存至多capacity个状态；Lexer对象因此不能被多个线程同时使用
+    void useLazyAutomaton(bool enable = true, size_t capacity = LAZY_DFA_CAPACITY);
+    const DFA &getCombinedAutomaton() const { return combinedDFA; }
+    const LazyDFA &getLazyAutomaton() const { return lazyDFA; }
+    const std::vector<token_type_t> &getCombinedTypes() const { return tagTypes; }
+    bool isIgnored(const token_type_t &type) const { return ignoredTypes.find(type) != ignoredTypes.end(); }
+    // 逐个取出词法单元，供边词法分析边语法分析的场合使用（见TokenPipe）
+    bool next(ContextViewer &view, tok_id_t &type, size_t &offset, size_t &length) const;
+    TokenStream scan(const Viewer &viewer) const;
+    // 按行切分源文本并行扫描，结果（含行列号和错误报告）与scan完全相同；threads为0时使用硬件线程数
+    TokenStream scanParallel(const Viewer &viewer, size_t threads = 0) const;
+    std::vector<token> tokenize(const Viewer &viewer) const
+    {
+        return scan(viewer).toTokens();
+    }
     std::vector<token> tokenizeFile(const std::string &fileName) const
     {
         return tokenize(Viewer::fromFile(fileName));
@@ -12,6 +12,8 @@
 #include "regexp/define.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace std;
 
 void FiniteAutomaton::setStartState(state_id_t id)
@@ -37,16 +39,25 @@ bool FiniteAutomaton::accepts(Viewer &view, string &result, state_id_t start) co
 		return true;
 	}
 	Viewer subView = view; // 保存当前视图，用于回溯
-	if (transitions.find(start) != transitions.end())
+	const transition_list_t &available = transitions[start];
+	if (!available.eps.empty() || !available.edges.empty())
 	{
 		char c = subView.step(); // 获取当前字符，视图向后移动一位
-		transition_map_t available = transitions.at(start);
 		bool resFlag = false;
 		string tmpRes;			  // 保存当前匹配结果
 		Viewer tmpView = subView; // 保存当前视图，用于回溯
-		if (available.find(c) != available.end())
+		// 读入c可到达的状态，按编号升序尝试
+		vector<state_id_t> nextSet;
+		if (c == EPSILON)
+			nextSet = available.eps;
+		else
+			for (auto &edge : available.edges)
+				if (edge.first.contains(c))
+					nextSet.push_back(edge.second);
+		sort(nextSet.begin(), nextSet.end());
+		nextSet.erase(unique(nextSet.begin(), nextSet.end()), nextSet.end());
+		if (!nextSet.empty())
 		{
-			set<state_id_t> nextSet = available[c];
 			for (auto i : nextSet)
 			{
 				string nxtRes;
@@ -65,11 +76,12 @@ bool FiniteAutomaton::accepts(Viewer &view, string &result, state_id_t start) co
 				return true;
 			}
 		}
-		if (c != EPSILON && available.find(EPSILON) != available.end())
+		if (c != EPSILON && !available.eps.empty())
 		{
 			subView.skip(-1); // EPSILON转移不消耗字符，视图回退一位
 			tmpView = subView;
-			set<state_id_t> nextSet = available[EPSILON];
+			nextSet = available.eps;
+			sort(nextSet.begin(), nextSet.end());
 			for (auto i : nextSet)
 			{
 				string nxtRes;
@@ -119,18 +131,12 @@ void FiniteAutomaton::printStates() const
 void FiniteAutomaton::printTransitions() const
 {
 	info << "FiniteAutomaton: Transitions:" << endl;
-	for (const auto &transition : transitions)
+	for (state_id_t from = 0; from < transitions.size(); from++)
 	{
-		state_id_t from = transition.first;
-		for (const auto &symbol : transition.second)
-		{
-			char c = symbol.first;
-			const set<state_id_t> &to = symbol.second;
-			for (const auto &t : to)
-			{
-				cout << "    " << from << " --" << char2str(c) << "(" << int(c) << ")--> " << t << endl;
-			}
-		}
+		for (auto to : transitions[from].eps)
+			cout << "    " << from << " --" << char2str(EPSILON) << "--> " << to << endl;
+		for (auto &edge : transitions[from].edges)
+			cout << "    " << from << " --" << edge.first.desc() << "--> " << edge.second << endl;
 	}
 }
 
@@ -138,6 +144,7 @@ state_id_t FiniteAutomaton::addState(bool isFinal)
 {
 	state_id_t id = states.size();
 	states.push_back(State(id, isFinal));
+	transitions.emplace_back();
 	debug(1) << "add state: " << id << endl;
 	return id;
 }
@@ -145,5 +152,27 @@ state_id_t FiniteAutomaton::addState(bool isFinal)
 void FiniteAutomaton::addTransition(state_id_t from, state_id_t to, char symbol)
 {
 	debug(1) << "add transition: " << from << " --" << char2str(symbol) << "--> " << to << endl;
-	transitions[from][symbol].insert(to);
-}
\ No newline at end of file
+	if (symbol != EPSILON)
+	{
+		addTransition(from, to, CharSet::of(symbol));
+		return;
+	}
+	vector<state_id_t> &eps = transitions[from].eps;
+	if (find(eps.begin(), eps.end(), to) == eps.end())
+		eps.push_back(to);
+}
+
+void FiniteAutomaton::addTransition(state_id_t from, state_id_t to, const CharSet &chars)
+{
+	if (chars.empty())
+		return;
+	for (auto &edge : transitions[from].edges)
+	{
+		if (edge.second == to)
+		{
+			edge.first |= chars;
+			return;
+		}
+	}
+	transitions[from].edges.push_back(make_pair(chars, to));
+}
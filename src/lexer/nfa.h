@@ -11,6 +11,7 @@
 #pragma once
 
 #include "utils/view/viewer.h"
+#include "charset.h"
 
 #include <set>
 #include <vector>
@@ -19,7 +20,13 @@
 
 using state_id_t = size_t;
 using sub_nfa_t = std::pair<state_id_t, state_id_t>;
-using transition_map_t = std::unordered_map<char, std::set<state_id_t>>;
+
+// 某一状态出发的转移：ε转移，以及以字符类为标号的转移（同一目标状态的字符类合并为一条）
+struct transition_list_t
+{
+    std::vector<state_id_t> eps;
+    std::vector<std::pair<CharSet, state_id_t>> edges;
+};
 
 /**
  * @brief 非确定的有限状态自动机
@@ -34,24 +41,30 @@ class FiniteAutomaton
     };
     state_id_t startState = 0;                                    // 开始状态
     std::vector<State> states;                                    // 状态集合
-    std::unordered_map<state_id_t, transition_map_t> transitions; // 转移函数
+    std::vector<transition_list_t> transitions;                   // 转移函数，以状态编号为下标
 
 public:
     FiniteAutomaton() {}
     state_id_t addState(bool isFinal = false);                                    // 添加状态
     void setStartState(state_id_t id);                                            // 设置开始状态
     void setState(state_id_t id, bool isFinal);                                   // 设置状态（是否为终态）
-    void addTransition(state_id_t from, state_id_t to, char symbol);              // 添加转移
+    void addTransition(state_id_t from, state_id_t to, char symbol);              // 添加转移，symbol为EPSILON时为ε转移
+    void addTransition(state_id_t from, state_id_t to, const CharSet &chars);     // 添加以字符类为标号的转移
     bool accepts(Viewer &view, std::string &result, state_id_t start = -1) const; // 从指定状态开始匹配，递归地匹配每个字符，直到无法匹配为止
     void printStates() const;                                                     // 打印状态集合
     void printTransitions() const;                                                // 打印转移函数
 
-    std::vector<State> getStates() const
+    state_id_t getStartState() const
+    {
+        return startState;
+    }
+
+    const std::vector<State> &getStates() const
     {
         return states;
     }
 
-    std::unordered_map<size_t, transition_map_t> getTransitions()
+    const std::vector<transition_list_t> &getTransitions() const
     {
         return transitions;
     }
@@ -68,59 +68,31 @@ map<char, string> sym2str = {
     {NON_SPACE, "NON_SPACE"},
 };
 
-set<char> uni_set = []() -> set<char>
+CharSet uni_set = []() -> CharSet
 {
-    set<char> s;
-    for (char c = 0x09; c <= 0x0d; c++)
-    {
-        s.insert(c);
-    }
-    for (char c = 0x20; c <= 0x7e; c++)
-    {
-        s.insert(c);
-    }
+    CharSet s = CharSet::range(0x09, 0x0d);
+    s |= CharSet::range(0x20, 0x7e);
     return s;
 }();
 
-set<char> alpha_set = []() -> set<char>
+CharSet alpha_set = []() -> CharSet
 {
-    set<char> s;
-    for (char c = 'a'; c <= 'z'; c++)
-    {
-        s.insert(c);
-    }
-    for (char c = 'A'; c <= 'Z'; c++)
-    {
-        s.insert(c);
-    }
+    CharSet s = CharSet::range('a', 'z');
+    s |= CharSet::range('A', 'Z');
     return s;
 }();
 
-set<char> digit_set = {
-    '0',
-    '1',
-    '2',
-    '3',
-    '4',
-    '5',
-    '6',
-    '7',
-    '8',
-    '9',
-};
+CharSet digit_set = CharSet::range('0', '9');
 
-set<char> word_set = []() -> set<char>
+CharSet word_set = []() -> CharSet
 {
-    set<char> s = alpha_set;
-    for (char c : digit_set)
-    {
-        s.insert(c);
-    }
+    CharSet s = alpha_set;
+    s |= digit_set;
     s.insert('_');
     return s;
 }();
 
-set<char> space_set = {
+CharSet space_set = std::set<char>{
     '\t',
     '\n',
     '\r',
@@ -129,14 +101,10 @@ set<char> space_set = {
     ' ',
 };
 
-set<char> non_space_set = []() -> set<char>
+CharSet non_space_set = []() -> CharSet
 {
-    set<char> s;
-    s.insert(uni_set.begin(), uni_set.end());
-    for (char c : space_set)
-    {
-        s.erase(c);
-    }
+    CharSet s = uni_set;
+    s -= space_set;
     return s;
 }();
 
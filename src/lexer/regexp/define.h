@@ -11,6 +11,7 @@
 #pragma once
 
 #include "utils/view/viewer.h"
+#include "lexer/charset.h"
 
 #include <map>
 #include <set>
@@ -53,17 +54,18 @@ extern std::map<char, std::string> op2str;
 
 extern std::map<char, std::string> sym2str;
 
-extern std::set<char> uni_set;
+// 预定义的字符类
+extern CharSet uni_set;
 
-extern std::set<char> alpha_set;
+extern CharSet alpha_set;
 
-extern std::set<char> digit_set;
+extern CharSet digit_set;
 
-extern std::set<char> word_set;
+extern CharSet word_set;
 
-extern std::set<char> space_set;
+extern CharSet space_set;
 
-extern std::set<char> non_space_set;
+extern CharSet non_space_set;
 
 std::string char2str(char c);
 
@@ -77,10 +77,11 @@ void RegexpParser::parseSet(string setExp)
 		}
 	}
 	Viewer view(pExpStr);
-	set<char> tmpSet;
+	// 整个字符集保持为一个位图，只产生一条转移
+	CharSet tmpSet;
 	if (reverse)
 	{
-		tmpSet.insert(uni_set.begin(), uni_set.end()); // 插入全集
+		tmpSet = uni_set; // 全集
 	}
 	while (!view.ends())
 	{
@@ -88,15 +89,15 @@ void RegexpParser::parseSet(string setExp)
 		if (view.peek() == '-' && view.peek(1) >= c)
 		{
 			char e = view.peek(1);
-			for (char t = c; t <= e; t++)
+			for (int t = c; t <= e; t++)
 			{
 				if (reverse)
 					tmpSet.erase(t);
-				else if (uni_set.find(t) != uni_set.end())
+				else if (uni_set.contains(t))
 					tmpSet.insert(t);
 				else
 				{
-					error << "invalid character in set: (int)" << int(t) << endl;
+					error << "invalid character in set: (int)" << t << endl;
 					exit(1);
 				}
 			}
@@ -105,43 +106,43 @@ void RegexpParser::parseSet(string setExp)
 		else if (c == WORD)
 		{
 			if (reverse)
-				tmpSet.erase(word_set.begin(), word_set.end());
+				tmpSet -= word_set;
 			else
-				tmpSet.insert(word_set.begin(), word_set.end());
+				tmpSet |= word_set;
 		}
 		else if (c == ALPHA)
 		{
 			if (reverse)
-				tmpSet.erase(alpha_set.begin(), alpha_set.end());
+				tmpSet -= alpha_set;
 			else
-				tmpSet.insert(alpha_set.begin(), alpha_set.end());
+				tmpSet |= alpha_set;
 		}
 		else if (c == DIGIT)
 		{
 			if (reverse)
-				tmpSet.erase(digit_set.begin(), digit_set.end());
+				tmpSet -= digit_set;
 			else
-				tmpSet.insert(digit_set.begin(), digit_set.end());
+				tmpSet |= digit_set;
 		}
 		else if (c == SPACE)
 		{
 			if (reverse)
-				tmpSet.erase(space_set.begin(), space_set.end());
+				tmpSet -= space_set;
 			else
-				tmpSet.insert(space_set.begin(), space_set.end());
+				tmpSet |= space_set;
 		}
 		else if (c == NON_SPACE)
 		{
 			if (reverse)
-				tmpSet.erase(non_space_set.begin(), non_space_set.end());
+				tmpSet -= non_space_set;
 			else
-				tmpSet.insert(non_space_set.begin(), non_space_set.end());
+				tmpSet |= non_space_set;
 		}
 		else
 		{
 			if (reverse)
 				tmpSet.erase(c);
-			else if (uni_set.find(c) != uni_set.end())
+			else if (uni_set.contains(c))
 				tmpSet.insert(c);
 			else
 			{
@@ -150,11 +151,7 @@ void RegexpParser::parseSet(string setExp)
 			}
 		}
 	}
-	// 将tmpSet中的字符转换为转换函数
-	for (const auto c : tmpSet)
-	{
-		nfa.addTransition(st, ed, c);
-	}
+	nfa.addTransition(st, ed, tmpSet);
 	setStates.push_back(st);
 	setStates.push_back(ed);
 }
@@ -394,10 +391,7 @@ void RegexpParser::postfix2FA()
 			debug(0) << "postfix2FA: Executing UNI" << endl;
 			int st = nfa.addState(false);
 			int ed = nfa.addState(true);
-			for (auto &c : uni_set)
-			{
-				nfa.addTransition(st, ed, c);
-			}
+			nfa.addTransition(st, ed, uni_set);
 			sub_nfa_t subNFA = make_pair(st, ed);
 			nfaStack.push(subNFA);
 		}
@@ -406,10 +400,7 @@ void RegexpParser::postfix2FA()
 			debug(0) << "postfix2FA: Executing WORD" << endl;
 			int st = nfa.addState(false);
 			int ed = nfa.addState(true);
-			for (auto &c : word_set)
-			{
-				nfa.addTransition(st, ed, c);
-			}
+			nfa.addTransition(st, ed, word_set);
 			sub_nfa_t subNFA = make_pair(st, ed);
 			nfaStack.push(subNFA);
 		}
@@ -418,10 +409,7 @@ void RegexpParser::postfix2FA()
 			debug(0) << "postfix2FA: Push ALPHA" << endl;
 			int st = nfa.addState(false);
 			int ed = nfa.addState(true);
-			for (auto &c : alpha_set)
-			{
-				nfa.addTransition(st, ed, c);
-			}
+			nfa.addTransition(st, ed, alpha_set);
 			sub_nfa_t subNFA = make_pair(st, ed);
 			nfaStack.push(subNFA);
 		}
@@ -430,10 +418,7 @@ void RegexpParser::postfix2FA()
 			debug(0) << "postfix2FA: Push DIGIT" << endl;
 			int st = nfa.addState(false);
 			int ed = nfa.addState(true);
-			for (auto &c : digit_set)
-			{
-				nfa.addTransition(st, ed, c);
-			}
+			nfa.addTransition(st, ed, digit_set);
 			sub_nfa_t subNFA = make_pair(st, ed);
 			nfaStack.push(subNFA);
 		}
@@ -442,10 +427,7 @@ void RegexpParser::postfix2FA()
 			debug(0) << "postfix2FA: Push SPACE" << endl;
 			int st = nfa.addState(false);
 			int ed = nfa.addState(true);
-			for (auto &c : space_set)
-			{
-				nfa.addTransition(st, ed, c);
-			}
+			nfa.addTransition(st, ed, space_set);
 			sub_nfa_t subNFA = make_pair(st, ed);
 			nfaStack.push(subNFA);
 		}
@@ -454,10 +436,7 @@ void RegexpParser::postfix2FA()
 			debug(0) << "postfix2FA: Push NON_SPACE" << endl;
 			int st = nfa.addState(false);
 			int ed = nfa.addState(true);
-			for (auto &c : non_space_set)
-			{
-				nfa.addTransition(st, ed, c);
-			}
+			nfa.addTransition(st, ed, non_space_set);
 			sub_nfa_t subNFA = make_pair(st, ed);
 			nfaStack.push(subNFA);
 		}
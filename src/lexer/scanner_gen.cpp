@@ -0,0 +1,202 @@
+/**
+ * @file scanner_gen.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Direct-coded Scanner Generator
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "scanner_gen.h"
+#include "utils/log.h"
+
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+ScannerGenerator::ScannerGenerator(const Lexer &lexer, const string &name)
+    : name(name), dfa(lexer.getCombinedAutomaton())
+{
+    assert(dfa.size() > 1, "ScannerGenerator: The lexer has no combined automaton, call useCombinedAutomaton() first.");
+    for (auto &type : lexer.getCombinedTypes())
+    {
+        types.push_back(*type);
+        ignored.push_back(lexer.isIgnored(type));
+    }
+}
+
+// 转义为C++字符串字面量
+static string literal(const string &s)
+{
+    string res = "\"";
+    for (unsigned char c : s)
+    {
+        if (c == '"' || c == '\\')
+            res += '\\', res += c;
+        else if (c < 0x20 || c >= 0x7f) // 八进制转义至多三位，不会吞掉后面的字符
+            res += {'\\', char('0' + (c >> 6)), char('0' + ((c >> 3) & 7)), char('0' + (c & 7))};
+        else
+            res += c;
+    }
+    return res + "\"";
+}
+
+void ScannerGenerator::emitHeader(ostream &os) const
+{
+    os << "// Generated by ScannerGenerator from the combined automaton of a Lexer, do not edit.\n"
+       << "#pragma once\n\n"
+       << "#include <cstddef>\n#include <vector>\n#include <string_view>\n\n"
+       << "namespace " << name << "_scanner\n{\n"
+       << "    constexpr unsigned TYPE_COUNT = " << types.size() << ";\n"
+       << "    constexpr unsigned NO_TYPE = 0xFFFFFFFFu;\n\n"
+       << "    extern const char *const typeNames[TYPE_COUNT];\n"
+       << "    extern const bool ignored[TYPE_COUNT];\n\n"
+       << "    struct token_t\n    {\n"
+       << "        unsigned type;\n        size_t offset;\n        size_t length;\n    };\n\n"
+       << "    // 从begin开始的最长匹配长度，0表示未匹配；多个类型匹配同样长度时取规则在前的类型\n"
+       << "    size_t match(const char *begin, const char *end, unsigned &type);\n"
+       << "    // 从pos开始取下一个未被忽略的词法单元，无法匹配时跳到下一行并累计failures\n"
+       << "    bool next(std::string_view src, size_t &pos, token_t &tok, size_t *failures = nullptr);\n"
+       << "    std::vector<token_t> scan(std::string_view src, size_t *failures = nullptr);\n"
+       << "}\n";
+}
+
+/**
+ * @brief 生成直接编码的匹配函数
+ * 每个状态一个标号；进入终态时按优先级记录匹配（与DFA::match相同），然后读入一个字节按等价类跳转
+ * 转到死状态的等价类归入default，直接结束匹配
+ */
+void ScannerGenerator::emitMatch(ostream &os) const
+{
+    const auto &table = dfa.getTable();
+    const auto &tags = dfa.getTags();
+    const size_t K = dfa.getClassCount();
+    const dfa_state_t start = dfa.getStartState();
+    vector<bool> referenced(dfa.size(), false);
+    for (auto t : table)
+        referenced[t] = true;
+    bool startAccepts = tags[start] != DFA_NO_TAG;
+
+    os << "    size_t match(const char *begin, const char *end, unsigned &type)\n    {\n"
+       << "        const char *p = begin;\n"
+       << "        size_t matched = 0;\n"
+       << "        unsigned best = NO_TYPE;\n"
+       << "        goto s" << start << (startAccepts ? "_scan" : "") << ";\n";
+    for (dfa_state_t s = 1; s < dfa.size(); s++)
+    {
+        if (referenced[s] || (s == start && !startAccepts))
+            os << "    s" << s << ":\n";
+        dfa_tag_t tag = tags[s];
+        if (tag == 0)
+            os << "        best = 0;\n        matched = p - begin;\n";
+        else if (tag != DFA_NO_TAG)
+            os << "        if (best >= " << tag << "u)\n        {\n"
+               << "            best = " << tag << "u;\n            matched = p - begin;\n        }\n";
+        if (s == start && startAccepts)
+            os << "    s" << s << "_scan:\n";
+        os << "        if (p == end)\n            goto done;\n"
+           << "        switch (byteClass[(unsigned char)*p++])\n        {\n";
+        map<dfa_state_t, vector<size_t>> cases; // 目标状态 -> 等价类
+        for (size_t k = 0; k < K; k++)
+            if (table[s * K + k] != DFA_DEAD)
+                cases[table[s * K + k]].push_back(k);
+        for (auto &c : cases)
+        {
+            for (auto k : c.second)
+                os << "        case " << k << ":\n";
+            os << "            goto s" << c.first << ";\n";
+        }
+        os << "        default:\n            goto done;\n        }\n";
+    }
+    os << "    done:\n"
+       << "        type = best;\n"
+       << "        return matched;\n    }\n";
+}
+
+void ScannerGenerator::emitSource(ostream &os) const
+{
+    const auto &classes = dfa.getByteClasses();
+    os << "// Generated by ScannerGenerator from the combined automaton of a Lexer, do not edit.\n"
+       << "// " << dfa.size() << " states, " << dfa.getClassCount() << " byte classes.\n"
+       << "#include \"" << name << "_scanner.h\"\n\n"
+       << "namespace " << name << "_scanner\n{\n"
+       << "    const char *const typeNames[TYPE_COUNT] = {";
+    for (size_t i = 0; i < types.size(); i++)
+        os << (i ? ", " : "") << literal(types[i]);
+    os << "};\n    const bool ignored[TYPE_COUNT] = {";
+    for (size_t i = 0; i < ignored.size(); i++)
+        os << (i ? ", " : "") << (ignored[i] ? "true" : "false");
+    os << "};\n\n    static constexpr unsigned char byteClass[256] = {";
+    for (size_t c = 0; c < DFA_ALPHABET; c++)
+        os << (c % 16 ? " " : "\n        ") << (unsigned)classes[c] << ",";
+    os << "\n    };\n\n";
+    emitMatch(os);
+    os << "\n    bool next(std::string_view src, size_t &pos, token_t &tok, size_t *failures)\n    {\n"
+       << "        while (pos < src.size())\n        {\n"
+       << "            unsigned type;\n"
+       << "            size_t len = match(src.data() + pos, src.data() + src.size(), type);\n"
+       << "            if (len == 0)\n            {\n"
+       << "                if (failures)\n                    (*failures)++;\n"
+       << "                size_t nl = src.find('\\n', pos);\n"
+       << "                pos = nl == std::string_view::npos ? src.size() : nl + 1;\n"
+       << "                continue;\n            }\n"
+       << "            size_t offset = pos;\n"
+       << "            pos += len;\n"
+       << "            if (ignored[type])\n                continue;\n"
+       << "            tok = {type, offset, len};\n"
+       << "            return true;\n        }\n"
+       << "        return false;\n    }\n\n"
+       << "    std::vector<token_t> scan(std::string_view src, size_t *failures)\n    {\n"
+       << "        std::vector<token_t> tokens;\n"
+       << "        tokens.reserve(src.size() / 4);\n"
+       << "        size_t pos = 0;\n"
+       << "        token_t tok;\n"
+       << "        while (next(src, pos, tok, failures))\n            tokens.push_back(tok);\n"
+       << "        return tokens;\n    }\n"
+       << "}\n";
+}
+
+string ScannerGenerator::header() const
+{
+    stringstream ss;
+    emitHeader(ss);
+    return ss.str();
+}
+
+string ScannerGenerator::source() const
+{
+    stringstream ss;
+    emitSource(ss);
+    return ss.str();
+}
+
+bool ScannerGenerator::generate(const string &dir) const
+{
+    filesystem::create_directories(dir);
+    // 内容未变时不重写，避免触发依赖它的目标重新编译
+    auto write = [](const string &path, const string &content)
+    {
+        ifstream ifs(path, ios::binary);
+        if (ifs && string(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>()) == content)
+            return true;
+        ifs.close();
+        ofstream ofs(path, ios::binary | ios::trunc);
+        ofs << content;
+        return (bool)ofs;
+    };
+    string base = dir + "/" + name + "_scanner";
+    if (!write(base + ".h", header()) || !write(base + ".cpp", source()))
+    {
+        error << "ScannerGenerator: Failed to write " << base << ".h/.cpp" << endl;
+        return false;
+    }
+    info << "ScannerGenerator: " << base << ".cpp generated, " << dfa.size() << " states, "
+         << dfa.getClassCount() << " byte classes." << endl;
+    return true;
+}
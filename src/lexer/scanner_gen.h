@@ -0,0 +1,51 @@
+/**
+ * @file scanner_gen.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Direct-coded Scanner Generator
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 由词法分析器的合并自动机（最小化的DFA）生成独立的C++扫描器源文件
+ * 生成的扫描器不依赖本项目的任何代码：
+ * 1、字节等价类为一张constexpr表
+ * 2、每个DFA状态是一个标号，状态内对等价类做switch，转移即goto，终态在入口处记录匹配长度和规则
+ * 3、忽略的类型、匹配失败时跳到下一行等行为与Lexer::next一致，得到的词法单元序列与Lexer::scan完全相同
+ * 生成的文件为<name>_scanner.h和<name>_scanner.cpp，接口位于命名空间<name>_scanner中：
+ *     size_t match(const char *begin, const char *end, unsigned &type); // 最长匹配，类型按规则优先
+ *     bool next(std::string_view src, size_t &pos, token_t &tok);        // 跳过忽略的类型，取下一个词法单元
+ *     std::vector<token_t> scan(std::string_view src);                  // 切分整个源文本
+ * 类型编号即Lexer::getCombinedTypes()中的下标，类型名在typeNames中
+ */
+
+#pragma once
+
+#include "lexer.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+class ScannerGenerator
+{
+    std::string name;                // 扫描器名，用于命名空间和文件名
+    DFA dfa;                         // 合并自动机
+    std::vector<std::string> types;  // 标签 -> 类型名
+    std::vector<bool> ignored;       // 标签 -> 是否忽略
+
+    void emitMatch(std::ostream &os) const;
+
+public:
+    // lexer须已启用合并自动机（且未启用按需确定化）
+    ScannerGenerator(const Lexer &lexer, const std::string &name);
+
+    void emitHeader(std::ostream &os) const;
+    void emitSource(std::ostream &os) const;
+    std::string header() const;
+    std::string source() const;
+    // 在目录dir下写出<name>_scanner.h和<name>_scanner.cpp
+    bool generate(const std::string &dir) const;
+};
@@ -0,0 +1,177 @@
+/**
+ * @file skip.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Vectorized Run Skipping
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "skip.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SKIP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SKIP_SSE2
+#endif
+
+using namespace std;
+
+constexpr unsigned SKIP_BYTES = 256;
+
+skip_kernel_t skip_kernel_t::of(const CharSet &set)
+{
+    skip_kernel_t k;
+    k.set = set;
+    size_t n = set.count();
+    if (n == 0)
+        return k;
+    if (SKIP_BYTES - n <= SKIP_MAX_STOPS)
+    {
+        k.kind = SKIP_UNTIL;
+        (~set).foreach ([&](unsigned c)
+                        { k.lo[k.count++] = c; });
+        return k;
+    }
+    unsigned c = 0;
+    while (c < SKIP_BYTES)
+    {
+        if (!set.contains(c))
+        {
+            c++;
+            continue;
+        }
+        if (k.count == SKIP_MAX_RANGES)
+        {
+            k.count = 0;
+            return k;
+        }
+        unsigned e = c;
+        while (e + 1 < SKIP_BYTES && set.contains(e + 1))
+            e++;
+        k.lo[k.count] = c;
+        k.hi[k.count] = e;
+        k.count++;
+        c = e + 1;
+    }
+    k.kind = SKIP_RANGES;
+    return k;
+}
+
+#if defined(SKIP_AVX2)
+
+const char *skip_kernel_t::skip(const char *p, const char *end) const
+{
+    if (kind == SKIP_UNTIL)
+    {
+        if (count == 0)
+            return end;
+        __m256i stop[SKIP_MAX_STOPS];
+        for (size_t i = 0; i < count; i++)
+            stop[i] = _mm256_set1_epi8((char)lo[i]);
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *)p);
+            __m256i hit = _mm256_cmpeq_epi8(v, stop[0]);
+            for (size_t i = 1; i < count; i++)
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, stop[i]));
+            uint32_t m = _mm256_movemask_epi8(hit);
+            if (m != 0)
+                return p + countr_zero(m);
+        }
+    }
+    else if (kind == SKIP_RANGES)
+    {
+        // x在[lo, hi]中当且仅当无符号的x - lo <= hi - lo，即min(x - lo, hi - lo) == x - lo
+        __m256i base[SKIP_MAX_RANGES], span[SKIP_MAX_RANGES];
+        for (size_t i = 0; i < count; i++)
+        {
+            base[i] = _mm256_set1_epi8((char)lo[i]);
+            span[i] = _mm256_set1_epi8((char)(hi[i] - lo[i]));
+        }
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *)p);
+            __m256i in = _mm256_setzero_si256();
+            for (size_t i = 0; i < count; i++)
+            {
+                __m256i t = _mm256_sub_epi8(v, base[i]);
+                in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_min_epu8(t, span[i]), t));
+            }
+            uint32_t m = ~(uint32_t)_mm256_movemask_epi8(in);
+            if (m != 0)
+                return p + countr_zero(m);
+        }
+    }
+    while (p != end && set.contains(*p))
+        p++;
+    return p;
+}
+
+#elif defined(SKIP_SSE2)
+
+const char *skip_kernel_t::skip(const char *p, const char *end) const
+{
+    if (kind == SKIP_UNTIL)
+    {
+        if (count == 0)
+            return end;
+        __m128i stop[SKIP_MAX_STOPS];
+        for (size_t i = 0; i < count; i++)
+            stop[i] = _mm_set1_epi8((char)lo[i]);
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            __m128i hit = _mm_cmpeq_epi8(v, stop[0]);
+            for (size_t i = 1; i < count; i++)
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, stop[i]));
+            uint32_t m = _mm_movemask_epi8(hit);
+            if (m != 0)
+                return p + countr_zero(m);
+        }
+    }
+    else if (kind == SKIP_RANGES)
+    {
+        // x在[lo, hi]中当且仅当无符号的x - lo <= hi - lo，即min(x - lo, hi - lo) == x - lo
+        __m128i base[SKIP_MAX_RANGES], span[SKIP_MAX_RANGES];
+        for (size_t i = 0; i < count; i++)
+        {
+            base[i] = _mm_set1_epi8((char)lo[i]);
+            span[i] = _mm_set1_epi8((char)(hi[i] - lo[i]));
+        }
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            __m128i in = _mm_setzero_si128();
+            for (size_t i = 0; i < count; i++)
+            {
+                __m128i t = _mm_sub_epi8(v, base[i]);
+                in = _mm_or_si128(in, _mm_cmpeq_epi8(_mm_min_epu8(t, span[i]), t));
+            }
+            uint32_t m = ~_mm_movemask_epi8(in) & 0xFFFF;
+            if (m != 0)
+                return p + countr_zero(m);
+        }
+    }
+    while (p != end && set.contains(*p))
+        p++;
+    return p;
+}
+
+#else
+
+const char *skip_kernel_t::skip(const char *p, const char *end) const
+{
+    if (kind == SKIP_UNTIL && count == 0)
+        return end;
+    while (p != end && set.contains(*p))
+        p++;
+    return p;
+}
+
+#endif
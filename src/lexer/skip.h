@@ -0,0 +1,50 @@
+/**
+ * @file skip.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Vectorized Run Skipping
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 自动机自环的加速
+ * 空白（\s+）、行注释体（[^\r\n]*）、块注释体（[^\*]）、标识符（[\w]*）等规则在DFA中表现为
+ * 在一大段输入上停留于同一状态的自环，逐字节查表时每个字节都要走一遍转移
+ * 对于自环字节集合形状简单的状态，一次检查16（SSE2）或32（AVX2）个字节，直接跳到第一个离开自环的字节：
+ * 1、SKIP_UNTIL：集合的补集至多3个字节，如[^\r\n]、[^\*]，逐个比较停止字节
+ * 2、SKIP_RANGES：集合为至多4个区间之并，如[\t-\r ]、[0-9A-Z_a-z]，逐个做区间判断
+ * 编译器未启用SSE2/AVX2（如非x86平台）时使用逐字节的标量实现
+ */
+
+#pragma once
+
+#include "charset.h"
+
+#include <cstdint>
+
+enum skip_kind_t : uint8_t
+{
+    SKIP_NONE,   // 不加速
+    SKIP_UNTIL,  // 跳过停止字节以外的所有字节
+    SKIP_RANGES, // 跳过落在若干区间中的字节
+};
+
+constexpr size_t SKIP_MAX_STOPS = 3;  // SKIP_UNTIL的最大停止字节数
+constexpr size_t SKIP_MAX_RANGES = 4; // SKIP_RANGES的最大区间数
+constexpr size_t SKIP_MIN_LOOPS = 2;  // 自环连续经过的字节数达到该值后才使用跳过，避免短词法单元上的额外开销
+
+struct skip_kernel_t
+{
+    skip_kind_t kind = SKIP_NONE;
+    uint8_t count = 0;                  // 停止字节或区间的个数
+    uint8_t lo[SKIP_MAX_RANGES] = {};   // SKIP_UNTIL时为停止字节，SKIP_RANGES时为区间下界
+    uint8_t hi[SKIP_MAX_RANGES] = {};   // SKIP_RANGES时为区间上界（闭区间）
+    CharSet set;                        // 被跳过的字节集合
+
+    // 识别集合的形状，不适合加速时kind为SKIP_NONE
+    static skip_kernel_t of(const CharSet &set);
+    // 返回[p, end)中第一个不在集合中的字节的位置，全部在集合中时返回end
+    const char *skip(const char *p, const char *end) const;
+};
@@ -0,0 +1,440 @@
+/**
+ * @file compiled.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Precompiled Grammar Artifact
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "compiled.h"
+#include "syntax.h"
+#include "utils/log.h"
+#include "utils/view/mmap.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+#define DEBUG_LEVEL -1
+
+static const char GRAM_MAGIC[8] = {'S', 'A', 'T', 'G', 'R', 'A', 'M', '\0'};
+static const uint32_t GRAM_VERSION = 2;
+static const uint32_t NONE = UINT32_MAX;
+
+enum section_id
+{
+    SEC_META,     // 各项计数，见meta_index
+    SEC_STRINGS,  // 字符串池
+    SEC_SYMBOLS,  // [名称偏移, 名称长度] * 符号数
+    SEC_PRODUCTS, // [左部, 右部偏移, 右部长度, 语义偏移, 语义长度] * 产生式数
+    SEC_RHS,      // 所有产生式右部的符号编号
+    SEC_MULTERMS, // 字面量终结符的符号编号
+    SEC_PREC,     // [名称偏移, 名称长度, 优先级, 结合性] * 项数
+    SEC_TOKMAP,   // [词法单元类型名偏移, 长度, 符号编号] * 项数
+    SEC_ACTION,   // ACTION表
+    SEC_GOTO,     // GOTO表
+    SEC_LEXTYPES, // [类型名偏移, 长度, 是否忽略] * 合并自动机的标签数
+    SEC_DFA,      // 合并自动机的转移表
+    SEC_DFA_TAGS, // 合并自动机的终态标签
+    SEC_DFA_CLS,  // 合并自动机的字节等价类映射，256项
+    SEC_COUNT
+};
+
+enum meta_index
+{
+    META_START,
+    META_STATES,
+    META_DFA_START,
+    META_TERMS, // 终结符数，符号编号小于它的是终结符
+    META_COUNT
+};
+
+struct section_t
+{
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+struct gram_header_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t sectionCount;
+    uint64_t key;
+    section_t sections[SEC_COUNT];
+};
+
+/**
+ * @brief 预编译文件的写入缓冲区
+ * 各节依次写入，每节起始位置按8字节对齐
+ */
+class GramWriter
+{
+    string pool;
+    vector<vector<uint32_t>> secs;
+
+public:
+    GramWriter() : secs(SEC_COUNT) {}
+    vector<uint32_t> &operator[](size_t id)
+    {
+        return secs[id];
+    }
+    // 将字符串放入字符串池，并在节id中记录其偏移和长度
+    void putStr(size_t id, const string &s)
+    {
+        secs[id].push_back(pool.size());
+        secs[id].push_back(s.size());
+        pool += s;
+    }
+    void write(const string &path, uint64_t key) const
+    {
+        gram_header_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, GRAM_MAGIC, sizeof(GRAM_MAGIC));
+        header.version = GRAM_VERSION;
+        header.sectionCount = SEC_COUNT;
+        header.key = key;
+        uint64_t offset = sizeof(header);
+        auto align = [](uint64_t x)
+        { return (x + 7) & ~uint64_t(7); };
+        for (size_t i = 0; i < SEC_COUNT; i++)
+        {
+            uint64_t bytes = i == SEC_STRINGS ? pool.size() : secs[i].size() * sizeof(uint32_t);
+            header.sections[i] = {offset, bytes};
+            offset = align(offset + bytes);
+        }
+        ofstream ofs(path, ios::binary | ios::trunc);
+        assert(ofs.is_open(), format("CompiledGrammar: Cannot write $.", path));
+        ofs.write((const char *)&header, sizeof(header));
+        const char zeros[8] = {0};
+        for (size_t i = 0; i < SEC_COUNT; i++)
+        {
+            const section_t &sec = header.sections[i];
+            if (i == SEC_STRINGS)
+                ofs.write(pool.data(), pool.size());
+            else
+                ofs.write((const char *)secs[i].data(), sec.bytes);
+            ofs.write(zeros, align(sec.offset + sec.bytes) - (sec.offset + sec.bytes));
+        }
+    }
+};
+
+uint64_t CompiledGrammar::hashFiles(const vector<string> &paths)
+{
+    // FNV-1a，依次混入格式版本、各文件的长度和内容
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const char *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            h ^= (unsigned char)data[i];
+            h *= 1099511628211ull;
+        }
+    };
+    mix((const char *)&GRAM_VERSION, sizeof(GRAM_VERSION));
+    for (auto &path : paths)
+    {
+        string content = Viewer::fromFile(path).getStr();
+        uint64_t size = content.size();
+        mix((const char *)&size, sizeof(size));
+        mix(content.data(), content.size());
+    }
+    return h;
+}
+
+void CompiledGrammar::save(const string &path, uint64_t key, const SLR1Grammar &g, const Lexer &lexer)
+{
+    info << "CompiledGrammar: Saving to " << path << "..." << endl;
+    PackedLRTable table(g);
+    const SymbolInterner &symtab = table.symtab;
+    GramWriter w;
+    w[SEC_META].resize(META_COUNT);
+    w[SEC_META][META_START] = symtab.id(g.symStart);
+    w[SEC_META][META_STATES] = table.size();
+    w[SEC_META][META_DFA_START] = lexer.getCombinedAutomaton().getStartState();
+    // 记录所有符号的类别，加载时据此恢复终结符和非终结符集合
+    w[SEC_META][META_TERMS] = symtab.terminalCount();
+    for (sym_id_t i = 0; i < symtab.size(); i++)
+        w.putStr(SEC_SYMBOLS, symtab.name(i));
+    for (auto &p : g.products)
+    {
+        auto &prod = w[SEC_PRODUCTS];
+        prod.push_back(symtab.id(p.first));
+        prod.push_back(w[SEC_RHS].size());
+        prod.push_back(p.second.size());
+        for (auto &s : p.second)
+            w[SEC_RHS].push_back(symtab.id(s));
+        auto it = g.semMap.find(p);
+        if (it == g.semMap.end())
+        {
+            prod.push_back(NONE);
+            prod.push_back(0);
+        }
+        else
+        {
+            w.putStr(SEC_PRODUCTS, it->second);
+        }
+    }
+    for (auto &t : g.mulTerms)
+        w[SEC_MULTERMS].push_back(symtab.id(t));
+    for (auto &prec : g.precMap)
+    {
+        w.putStr(SEC_PREC, prec.first);
+        w[SEC_PREC].push_back(prec.second.first);
+        w[SEC_PREC].push_back(prec.second.second);
+    }
+    for (auto &map : g.tok2sym)
+    {
+        if (map.first == nullptr)
+            continue;
+        w.putStr(SEC_TOKMAP, *map.first);
+        w[SEC_TOKMAP].push_back(symtab.id(map.second));
+    }
+    auto &action = table.getActionTable();
+    auto &go = table.getGotoTable();
+    w[SEC_ACTION].assign(action.begin(), action.end());
+    w[SEC_GOTO].assign(go.begin(), go.end());
+    for (auto &type : lexer.getCombinedTypes())
+    {
+        w.putStr(SEC_LEXTYPES, *type);
+        w[SEC_LEXTYPES].push_back(lexer.isIgnored(type));
+    }
+    auto &dfa = lexer.getCombinedAutomaton();
+    w[SEC_DFA].assign(dfa.getTable().begin(), dfa.getTable().end());
+    w[SEC_DFA_TAGS].assign(dfa.getTags().begin(), dfa.getTags().end());
+    w[SEC_DFA_CLS].assign(dfa.getByteClasses().begin(), dfa.getByteClasses().end());
+    w.write(path, key);
+}
+
+bool CompiledGrammar::load(const string &path, uint64_t key)
+{
+    string_view content;
+    shared_ptr<const void> h = mapFile(path, content);
+    if (h == nullptr || content.size() < sizeof(gram_header_t))
+        return false;
+    gram_header_t header;
+    memcpy(&header, content.data(), sizeof(header));
+    if (memcmp(header.magic, GRAM_MAGIC, sizeof(GRAM_MAGIC)) != 0 ||
+        header.version != GRAM_VERSION || header.sectionCount != SEC_COUNT)
+    {
+        warn << "CompiledGrammar: " << path << " is not a compiled grammar of this version." << endl;
+        return false;
+    }
+    if (header.key != key)
+    {
+        info << "CompiledGrammar: " << path << " is stale." << endl;
+        return false;
+    }
+    for (auto &sec : header.sections)
+    {
+        if (sec.offset % 4 != 0 || sec.offset + sec.bytes > content.size())
+        {
+            warn << "CompiledGrammar: " << path << " is corrupted." << endl;
+            return false;
+        }
+    }
+    holder = h;
+    blob = content;
+    if (!checkIndices())
+    {
+        warn << "CompiledGrammar: " << path << " is corrupted." << endl;
+        holder.reset();
+        blob = string_view();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledGrammar::checkIndices() const
+{
+    size_t n, symCount, rhsCount;
+    const gram_header_t *header = (const gram_header_t *)blob.data();
+    uint64_t poolSize = header->sections[SEC_STRINGS].bytes;
+    auto strOk = [&](uint32_t offset, uint32_t length)
+    { return (uint64_t)offset + length <= poolSize; };
+    const uint32_t *meta = section(SEC_META, n);
+    const uint32_t *syms = section(SEC_SYMBOLS, symCount);
+    symCount /= 2;
+    if (n < META_COUNT || meta[META_START] >= symCount || meta[META_TERMS] > symCount)
+        return false;
+    for (size_t i = 0; i < symCount; i++)
+        if (!strOk(syms[2 * i], syms[2 * i + 1]))
+            return false;
+    const uint32_t *rhs = section(SEC_RHS, rhsCount);
+    for (size_t i = 0; i < rhsCount; i++)
+        if (rhs[i] >= symCount)
+            return false;
+    const uint32_t *prods = section(SEC_PRODUCTS, n);
+    for (size_t i = 0; i + 5 <= n; i += 5)
+    {
+        if (prods[i] >= symCount || (uint64_t)prods[i + 1] + prods[i + 2] > rhsCount)
+            return false;
+        if (prods[i + 3] != NONE && !strOk(prods[i + 3], prods[i + 4]))
+            return false;
+    }
+    const uint32_t *mulTerms = section(SEC_MULTERMS, n);
+    for (size_t i = 0; i < n; i++)
+        if (mulTerms[i] >= symCount)
+            return false;
+    const uint32_t *prec = section(SEC_PREC, n);
+    for (size_t i = 0; i + 4 <= n; i += 4)
+        if (!strOk(prec[i], prec[i + 1]))
+            return false;
+    const uint32_t *tokMap = section(SEC_TOKMAP, n);
+    for (size_t i = 0; i + 3 <= n; i += 3)
+        if (!strOk(tokMap[i], tokMap[i + 1]) || tokMap[i + 2] >= symCount)
+            return false;
+    const uint32_t *types = section(SEC_LEXTYPES, n);
+    for (size_t i = 0; i + 3 <= n; i += 3)
+        if (!strOk(types[i], types[i + 1]))
+            return false;
+    return true;
+}
+
+const uint32_t *CompiledGrammar::section(size_t id, size_t &count) const
+{
+    const gram_header_t *header = (const gram_header_t *)blob.data();
+    count = header->sections[id].bytes / sizeof(uint32_t);
+    return (const uint32_t *)(blob.data() + header->sections[id].offset);
+}
+
+string_view CompiledGrammar::str(uint32_t offset, uint32_t length) const
+{
+    const gram_header_t *header = (const gram_header_t *)blob.data();
+    return blob.substr(header->sections[SEC_STRINGS].offset + offset, length);
+}
+
+Grammar CompiledGrammar::getGrammar() const
+{
+    size_t n;
+    const uint32_t *meta = section(SEC_META, n);
+    const uint32_t *syms = section(SEC_SYMBOLS, n);
+    size_t symCount = n / 2;
+    size_t termCount = meta[META_TERMS];
+    vector<symbol_t> names(symCount);
+    Grammar g;
+    for (size_t i = 0; i < symCount; i++)
+    {
+        names[i] = string(str(syms[2 * i], syms[2 * i + 1]));
+        if (i < termCount)
+            g.terminals.insert(names[i]);
+        else
+            g.nonTerms.insert(names[i]);
+    }
+    g.symStart = names[meta[META_START]];
+    const uint32_t *rhs = section(SEC_RHS, n);
+    const uint32_t *prods = section(SEC_PRODUCTS, n);
+    for (size_t i = 0; i + 5 <= n; i += 5)
+    {
+        product_t p;
+        p.first = names[prods[i]];
+        for (size_t j = 0; j < prods[i + 2]; j++)
+            p.second.push_back(names[rhs[prods[i + 1] + j]]);
+        g.rules[p.first].insert(p.second);
+        if (prods[i + 3] != NONE)
+            g.semMap[p] = string(str(prods[i + 3], prods[i + 4]));
+        g.products.push_back(move(p));
+    }
+    const uint32_t *mulTerms = section(SEC_MULTERMS, n);
+    for (size_t i = 0; i < n; i++)
+        g.mulTerms.insert(names[mulTerms[i]]);
+    const uint32_t *prec = section(SEC_PREC, n);
+    for (size_t i = 0; i + 4 <= n; i += 4)
+        g.precMap[string(str(prec[i], prec[i + 1]))] = make_pair(prec[i + 2], (assoc_t)prec[i + 3]);
+    const uint32_t *tokMap = section(SEC_TOKMAP, n);
+    for (size_t i = 0; i + 3 <= n; i += 3)
+    {
+        string typeName(str(tokMap[i], tokMap[i + 1]));
+        if (!find_tok_type(typeName))
+            set_tok_type(typeName, make_tok_type(typeName));
+        g.tok2sym[get_tok_type(typeName)] = names[tokMap[i + 2]];
+    }
+    g.internSymbols();
+    g.updateStartProduct();
+    return g;
+}
+
+PackedLRTable CompiledGrammar::getTable() const
+{
+    size_t n, nAction, nGoto;
+    const uint32_t *meta = section(SEC_META, n);
+    const uint32_t *syms = section(SEC_SYMBOLS, n);
+    symset_t terminals, nonTerms;
+    for (size_t i = 0; i < n / 2; i++)
+    {
+        string name(str(syms[2 * i], syms[2 * i + 1]));
+        (i < meta[META_TERMS] ? terminals : nonTerms).insert(name);
+    }
+    SymbolInterner symtab(terminals, nonTerms);
+    const uint32_t *action = section(SEC_ACTION, nAction);
+    const uint32_t *go = section(SEC_GOTO, nGoto);
+    const uint32_t *prods = section(SEC_PRODUCTS, n);
+    vector<uint32_t> reduceLen;
+    vector<sym_id_t> reduceLeft;
+    for (size_t i = 0; i + 5 <= n; i += 5)
+    {
+        reduceLeft.push_back(prods[i]);
+        reduceLen.push_back(prods[i + 2]);
+    }
+    return PackedLRTable(
+        symtab, meta[META_STATES],
+        vector<lr_entry_t>(action, action + nAction),
+        vector<lr_entry_t>(go, go + nGoto),
+        move(reduceLen), move(reduceLeft));
+}
+
+Lexer CompiledGrammar::getLexer() const
+{
+    size_t n, nTable, nTags;
+    const uint32_t *meta = section(SEC_META, n);
+    const uint32_t *types = section(SEC_LEXTYPES, n);
+    vector<token_type_t> tagTypes;
+    set<token_type_t, type_less> ignored;
+    for (size_t i = 0; i + 3 <= n; i += 3)
+    {
+        string typeName(str(types[i], types[i + 1]));
+        if (!find_tok_type(typeName))
+            set_tok_type(typeName, make_tok_type(typeName));
+        token_type_t type = get_tok_type(typeName);
+        tagTypes.push_back(type);
+        if (types[i + 2])
+            ignored.insert(type);
+    }
+    const uint32_t *table = section(SEC_DFA, nTable);
+    const uint32_t *tags = section(SEC_DFA_TAGS, nTags);
+    size_t nClasses;
+    const uint32_t *classes = section(SEC_DFA_CLS, nClasses);
+    array<uint8_t, DFA_ALPHABET> byteClass = {};
+    for (size_t c = 0; c < nClasses && c < DFA_ALPHABET; c++)
+        byteClass[c] = classes[c];
+    DFA dfa(
+        meta[META_DFA_START],
+        byteClass,
+        vector<dfa_state_t>(table, table + nTable),
+        vector<dfa_tag_t>(tags, tags + nTags));
+    return Lexer(dfa, tagTypes, ignored);
+}
+
+CompiledGrammar CompiledGrammar::build(
+    const string &syntaxLexPath, const string &grammarPath,
+    const string &codeLexPath, const string &cachePath)
+{
+    uint64_t key = hashFiles({syntaxLexPath, grammarPath, codeLexPath});
+    CompiledGrammar cg;
+    if (cg.load(cachePath, key))
+    {
+        info << "CompiledGrammar: Loaded " << cachePath << "." << endl;
+        return cg;
+    }
+    info << "CompiledGrammar: Rebuilding " << cachePath << "..." << endl;
+    SyntaxParser syntax(syntaxLexPath);
+    SLR1Grammar G(syntax.parse(grammarPath));
+    Lexer lexer(codeLexPath);
+    lexer.useCombinedAutomaton();
+    save(cachePath, key, G, lexer);
+    assert(cg.load(cachePath, key), format("CompiledGrammar: Failed to reload $.", cachePath));
+    return cg;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file compiled.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Precompiled Grammar Artifact
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 预编译文法文件
+ * 将一次完整构造得到的文法（符号表、产生式、语义标记、优先级、词法单元映射）、
+ * 冻结后的ACTION/GOTO表以及源代码词法分析器的合并自动机写入一个二进制文件
+ * 加载时只需一次内存映射和若干次连续拷贝，不再解析.lex/.estx文件，也不再构造LR项目集
+ *
+ * 文件以源文件内容的哈希值为键，任一源文件（或文件格式版本）发生变化时键随之变化，
+ * 此时加载失败并自动重新构造、覆盖旧文件
+ * 文件按本机字节序存储，不在不同字节序的平台间通用
+ */
+
+#pragma once
+
+#include "common/gram/slr1.h"
+#include "common/gram/lrtbl.h"
+#include "lexer/lexer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+class CompiledGrammar
+{
+    std::shared_ptr<const void> holder; // 映射句柄
+    std::string_view blob;              // 映射得到的文件内容
+
+    const uint32_t *section(size_t id, size_t &count) const;
+    std::string_view str(uint32_t offset, uint32_t length) const;
+    // 检查各节中的符号编号、右部位置和字符串位置是否越界
+    bool checkIndices() const;
+
+public:
+    static uint64_t hashFiles(const std::vector<std::string> &paths);
+    static void save(const std::string &path, uint64_t key, const SLR1Grammar &g, const Lexer &lexer);
+    // 加载预编译文件，文件不存在、损坏或键不匹配时返回false
+    bool load(const std::string &path, uint64_t key);
+    // 加载预编译文件，必要时由源文件重新构造
+    static CompiledGrammar build(
+        const std::string &syntaxLexPath, const std::string &grammarPath,
+        const std::string &codeLexPath, const std::string &cachePath);
+
+    Grammar getGrammar() const;
+    PackedLRTable getTable() const;
+    Lexer getLexer() const;
+};
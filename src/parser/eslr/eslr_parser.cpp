@@ -18,47 +18,13 @@
  */
 
 #include "parser.h"
-#include "utils/table.h"
+#include "parser/lr_driver.h"
 #include "utils/view/tok_view.h"
 
 #include <stack>
 #include <functional>
 
 using namespace std;
-using namespace table;
-
-/**
- * @brief 将符号栈转换为字符串，用于打印输出
- *
- * @tparam T 栈内元素类型
- * @param s 符号栈
- * @param limit 限制打印的元素数量，用于控制输出长度
- * @return string 符号栈的字符串表示
- */
-template <typename T>
-string descStack(stack<T> s, int limit = 6)
-{
-    stringstream ss;
-    symstr_t v;
-    // 逆序遍历栈中元素，将其转换为字符串并添加到vector中
-    // 最多添加limit个元素，超出部分用省略号代替
-    while (!s.empty() && limit--)
-    {
-        stringstream t;
-        t << s.top();
-        v.push_back(t.str());
-        s.pop();
-    }
-    // 如果栈中还有元素，说明超出了限制，添加省略号
-    if (limit <= 0)
-        v.push_back("...");
-    // 逆序遍历vector，将其转换为字符串
-    // 这里主要是为了将栈顶元素放在最后（右）面
-    reverse(v.begin(), v.end());
-    // 将vector转换为字符串
-    ss << container2str(v, " ", "");
-    return ss.str();
-}
 
 /**
  * @brief 将SLR1文法分析表中的动作(action)对转换为字符串，用于打印输出
@@ -132,49 +98,49 @@ bool ExtendedSimpleLR1Parser::parse(vector<token> &input, const ContextViewer &c
     // 将输入的token序列转换为TokenViewer，方便后续遍历
     input.push_back(token(make_shared<symbol_t>(SYM_END), SYM_END, 0, 0));
     TokenViewer viewer(input);
-    // 初始化栈
-    stack<symbol_t> symStk;       // 符号栈
-    stack<state_id_t> stateStk;   // 状态栈
+    // 初始化栈，符号栈和状态栈以vector保存（末尾为栈顶），描述时无需拷贝
+    vector<symbol_t> symStk;      // 符号栈
+    vector<state_id_t> stateStk;  // 状态栈
     stack<pst_node_ptr_t> cstStk; // 解析树栈（CST）
-    symStk.push(SYM_END);         // 符号栈初始加入结束符号
-    stateStk.push(0);             // 状态栈初始加入状态 0
-    // 初始化表头（用于打印输出分析过程）
-    tb_head | "Symbol/State" | "Input" | "Action";
-    set_row | AL_CTR;
+    symStk.push_back(SYM_END);    // 符号栈初始加入结束符号
+    stateStk.push_back(0);        // 状态栈初始加入状态 0
+    // 开始跟踪分析过程，每一步描述为两行：符号栈、当前符号、动作类型；状态栈、剩余输入、动作内容
+    tracer.begin({"Symbol/State", "Input", "Action"});
     token &tok = viewer.current();
     while (!stateStk.empty() && !symStk.empty() && !viewer.ends())
     {
         // 逐步遍历输入流，直到输入流结束
         tok = viewer.current();                         // 获取输入流的当前token
-        state_id_t s = stateStk.top();                  // 获取状态栈的栈顶状态
-        symbol_t a = *(tok.type);                       // 获取输入流的当前token代表的终结符
+        state_id_t s = stateStk.back();                 // 获取状态栈的栈顶状态
+        const symbol_t &a = *(tok.type);                // 获取输入流的当前token代表的终结符
         action_t &act = grammar.slr1Table[mkcrd(s, a)]; // 获取当前状态和当前终结符在SLR1分析表中对应的动作
-        // 打印输出分析过程
-        string act1, act2;
-        tie(act1, act2) = descAction(act); // 将动作转换为字符串，用于打印输出
-        // 将当前符号栈、状态栈、输入流和动作添加到打印表格中
-        new_row | Cell(descStack(symStk)) & AL_LFT | Cell(a) & AL_LFT | Cell(act1) & AL_LFT;
-        new_row | descStack(stateStk) | Cell(descTokVecFrom(input, viewer.pos())) & AL_RGT | Cell(act2) & AL_RGT;
-        tb_line();
+        // 跟踪分析过程，只有需要完整跟踪时才生成描述
+        tracer.step(
+            [&]()
+            {
+                auto [act1, act2] = descAction(act);
+                return vector<string>{descStack(symStk, 6), a, act1,
+                                      descStack(stateStk, 6), descTokVecFrom(input, viewer.pos()), act2};
+            });
         // 根据动作类型进行相应的处理
         if (holds_alternative<shift_t>(act))
         {
             // 移进动作
             shift_t shift = get<shift_t>(act); // 获取移进动作对应的状态
-            symStk.push(a);                    // 将当前终结符压入符号栈
-            stateStk.push(shift);              // 将移进动作对应的状态压入状态栈
+            symStk.push_back(a);               // 将当前终结符压入符号栈
+            stateStk.push_back(shift);         // 将移进动作对应的状态压入状态栈
             // 创建一个新的CST叶子节点，将当前终结符作为其数据
             pst_node_ptr_t node = pst_tree_t::createNode(TERMINAL, tok.value, tok.line, tok.col);
             cstStk.push(node); // 将新的CST节点压入解析树栈
             viewer.advance();  // 将输入流向前移动一个token
+            tracer.advance();
         }
         else if (holds_alternative<reduce_t>(act))
         {
             // 规约动作
             product_t &reduce = get<reduce_t>(act).get(); // 获取规约动作对应的产生式
-            symbol_t left = reduce.first;                 // 获取产生式左部
-            symstr_t right = reduce.second;               // 获取产生式右部
-            size_t len = right.size();                    // 获取产生式右部长度（即规约长度）
+            const symbol_t &left = reduce.first;          // 获取产生式左部
+            size_t len = reduce.second.size();            // 获取产生式右部长度（即规约长度）
             // 创建一个新的CST非叶子节点，将产生式左部作为其数据
             // 该节点的子节点为规约长度个数的CST节点，这些CST节点是从解析树栈中弹出的
             pst_node_ptr_t node = pst_tree_t::createNode(NON_TERM, left, 0, 0);
@@ -183,20 +149,20 @@ bool ExtendedSimpleLR1Parser::parse(vector<token> &input, const ContextViewer &c
             {
                 // 从解析树栈中弹出规约长度个数的CST节点，并添加到新的CST节点中
                 // 这里是逆序添加，因为解析树栈中的CST节点是按照规约顺序压入的
-                // 符号栈和状态栈中的元素也相应地弹出
-                symStk.pop();
-                stateStk.pop();
                 *node << cstStk.top();
                 cstStk.pop();
             }
+            // 符号栈和状态栈中的元素也相应地弹出
+            symStk.resize(symStk.size() - len);
+            stateStk.resize(stateStk.size() - len);
             // 将新的CST节点的子节点顺序逆转，保证其顺序与产生式右部一致
             node->reverseChildren();
-            symStk.push(left); // 将产生式左部压入符号栈
-            cstStk.push(node); // 将新的CST节点压入解析树栈
+            symStk.push_back(left); // 将产生式左部压入符号栈
+            cstStk.push(node);      // 将新的CST节点压入解析树栈
             // 根据产生式左部和当前状态在goto表中查找，得到下一个状态
-            action_t &nAct = grammar.slr1Table[mkcrd(stateStk.top(), left)];
+            action_t &nAct = grammar.slr1Table[mkcrd(stateStk.back(), left)];
             if (holds_alternative<shift_t>(nAct))
-                stateStk.push(get<shift_t>(nAct)); // 如果下一个状态是移进状态，将新的状态号压入状态栈
+                stateStk.push_back(get<shift_t>(nAct)); // 如果下一个状态是移进状态，将新的状态号压入状态栈
             else if (holds_alternative<accept_t>(nAct) && get<accept_t>(nAct))
                 goto accept; // 如果下一个状态是接受状态，说明分析成功，跳转到接受处理部分
             else
@@ -210,8 +176,7 @@ bool ExtendedSimpleLR1Parser::parse(vector<token> &input, const ContextViewer &c
     }
 reject: // 拒绝处理部分
     error << "ExtendedSimpleLR1Parser: Parsing failed!" << endl;
-    new_row | TB_TAB | MD_TAB | Cell("Rejected") & FORE_RED;
-    std::cout << tb_view(); // 打印输出分析表格
+    tracer.end(false); // 输出分析过程
     info << "ExtendedSimpleLR1Parser: Related context:" << endl;
     tok = viewer.current();               // 获取当前token
     code.printContext(tok.line, tok.col); // 打印当前Token的相关上下文信息
@@ -224,28 +189,180 @@ accept: // 接受处理部分
     // 获取文法开始符号对应的产生式
     grammar.updateStartProduct();
     product_t &startProduct = grammar.startProduct;
-    symstr_t &right = startProduct.second;
+    size_t len = startProduct.second.size();
     // 创建一个新的CST根节点（整个CST的根节点），将文法开始符号作为其数据
     pst_node_ptr_t startNode = pst_tree_t::createNode(NON_TERM, grammar.symStart, 0, 0);
     startNode->attachProduct(startProduct); // 将文法开始符号对应的产生式信息附加到新的CST节点上
-    for (size_t i = 0; i < right.size(); i++)
+    for (size_t i = 0; i < len; i++)
     {
         // 从解析树栈中弹出规约长度个数的CST节点，并添加到CST根节点中
-        symStk.pop();
-        stateStk.pop();
         *startNode << cstStk.top();
         cstStk.pop();
     }
+    symStk.resize(symStk.size() - len);
+    stateStk.resize(stateStk.size() - len);
     // 将CST根节点的子节点顺序逆转，保证其顺序与产生式右部一致
     startNode->reverseChildren();
     // 最终CST树的根节点即为文法开始符号对应的CST节点
     cst = startNode;
-    // 打印输出分析表格
-    new_row | Cell(descStack(symStk)) & AL_LFT | MD_TAB | Cell("Accepted") & FORE_GRE;
-    std::cout << tb_view();
+    // 输出分析过程，剩余的符号栈作为补充说明
+    tracer.end(true, tracer.full() ? descStack(symStk, 6) : "");
     return true;
 }
 
+// 首次以紧凑词法单元序列分析时冻结分析表
+void ExtendedSimpleLR1Parser::freezeTables()
+{
+    if (lrTable.size() == 0)
+        lrTable = PackedLRTable(grammar);
+    if (compressed && combTable.size() == 0)
+        combTable = CombLRTable(lrTable);
+}
+
+/**
+ * @brief 基于紧凑分析表的ESLR分析过程，构建的CST与上面的版本完全相同
+ * 分析循环只读取冻结后的ACTION/GOTO数组（或其压缩形式），不打印分析过程，适用于大规模输入
+ * 输入以拉取的方式读入，input为截至当前已读入的词法单元，移进第i个符号时其中至少有i+1个词法单元
+ *
+ * @param next 取下一个终结符编号的回调，见driveLRPull
+ * @param input 已读入的词法单元序列
+ * @param code 上下文浏览器，这里仅用于在出错时打印相关上下文信息
+ * @param sizeHint 预计的词法单元个数，用于预留树的空间
+ * @return true 解析成功
+ * @return false 解析失败
+ */
+template <typename next_fn_t>
+bool ExtendedSimpleLR1Parser::parseWith(next_fn_t next, const TokenStream &input, const ContextViewer &code, size_t sizeHint)
+{
+    info << "ExtendedSimpleLR1Parser: Parsing with packed table..." << endl;
+    freezeTables();
+    // CST建在连续存储的树中，结点只记录产生式编号和词法单元下标
+    arena.reset();
+    arena.reserve(sizeHint);
+    vector<arena_node_id_t> cstStk; // 解析树栈（CST）
+    vector<pst_node_ptr_t> astStk;  // 直接构建AST时与cstStk对齐的AST结点栈，终结符在被保留时才创建结点
+    if (directAST && astRules.size() != grammar.products.size())
+        calcASTRules();
+    auto reduce = [&](size_t p, size_t len)
+    {
+        span<const arena_node_id_t> kids(cstStk.data() + cstStk.size() - len, len);
+        arena_node_id_t node = arena.reduce(p, kids);
+        if (directAST)
+        {
+            pst_node_ptr_t astNode = reduceAST(p, kids, astStk.data() + astStk.size() - len, input);
+            astStk.resize(astStk.size() - len);
+            astStk.push_back(astNode);
+        }
+        cstStk.resize(cstStk.size() - len);
+        cstStk.push_back(node);
+    };
+    auto onShift = [&](size_t i)
+    {
+        // 结束符号不会被移进，i总是有效的词法单元下标
+        cstStk.push_back(arena.leaf(i));
+        if (directAST)
+            astStk.push_back(nullptr);
+    };
+    auto onReduce = [&](size_t p)
+    {
+        reduce(p, lrTable.productLength(p));
+    };
+    size_t errPos = compressed ? driveLRPull(combTable, next, onShift, onReduce)
+                               : driveLRPull(lrTable, next, onShift, onReduce);
+    if (errPos != LR_ACCEPTED)
+    {
+        error << "ExtendedSimpleLR1Parser: Parsing failed!" << endl;
+        info << "ExtendedSimpleLR1Parser: Related context:" << endl;
+        if (errPos < input.size())
+        {
+            auto lc = input.lineCol(errPos);
+            code.printContext(lc.first, lc.second);
+        }
+        info << "ExtendedSimpleLR1Parser: Remaining cst nodes:" << endl;
+        stack<pst_node_ptr_t> pstStk;
+        for (auto &node : arena.toPST(grammar, input, cstStk))
+            pstStk.push(node);
+        printRemainingTreeNodes(pstStk);
+        arena.reset();
+        return false;
+    }
+    info << "ExtendedSimpleLR1Parser: Parsing succeed!" << endl;
+    // 以文法开始符号的产生式规约得到根结点
+    grammar.updateStartProduct();
+    size_t start = find(grammar.products.begin(), grammar.products.end(), grammar.startProduct) - grammar.products.begin();
+    reduce(start, grammar.startProduct.second.size());
+    cst = nullptr; // 需要时再由getCST()转换
+    if (directAST)
+    {
+        rst = nullptr;
+        ast = astStk.back();
+    }
+    return true;
+}
+
+/**
+ * @brief 以预先切分好的紧凑词法单元序列分析
+ *
+ * @param input 经过Grammar::transferTokens转换的紧凑词法单元序列
+ * @param code 上下文浏览器，这里仅用于在出错时打印相关上下文信息
+ * @return true 解析成功
+ * @return false 解析失败
+ */
+bool ExtendedSimpleLR1Parser::parse(const TokenStream &input, const ContextViewer &code)
+{
+    freezeTables();
+    // 逐个词法单元查表得到终结符编号，不另行生成符号串
+    vector<sym_id_t> tok2sym = lrSymbolMap(lrTable.symtab);
+    sym_id_t endSym = lrTable.symtab.id(SYM_END);
+    size_t k = 0;
+    auto next = [&]()
+    {
+        if (k < input.size())
+            return tok2sym[input.typeId(k++)];
+        return k++ == input.size() ? endSym : SYM_NONE;
+    };
+    if (!parseWith(next, input, code, input.size()))
+        return false;
+    arenaTokens = input;
+    return true;
+}
+
+/**
+ * @brief 边词法分析边语法分析，词法单元在分析程序需要时才从源代码中取出并映射为文法符号
+ * 不生成完整的词法单元序列和符号串，异步模式下词法分析在预读线程中提前一到两块进行
+ *
+ * @param lexer 源代码的词法分析程序
+ * @param code 源代码
+ * @param async 是否使用预读线程
+ * @return true 解析成功
+ * @return false 解析失败
+ */
+bool ExtendedSimpleLR1Parser::parse(const Lexer &lexer, const Viewer &code, bool async)
+{
+    freezeTables();
+    TokenPipe pipe(lexer, grammar, lrTable.symtab, code, async);
+    auto next = [&]()
+    {
+        return pipe.next();
+    };
+    if (!parseWith(next, pipe.tokens(), pipe.tokens().getSource(), 0))
+        return false;
+    arenaTokens = pipe.release();
+    return true;
+}
+
+/**
+ * @brief 获取CST，以紧凑词法单元序列分析后首次调用时由连续存储的树转换得到
+ *
+ * @return pst_tree_ptr_t CST根结点
+ */
+pst_tree_ptr_t ExtendedSimpleLR1Parser::getCST()
+{
+    if (cst == nullptr && !arena.empty())
+        cst = arena.toPST(grammar, *arenaTokens);
+    return cst;
+}
+
 /**
  * @brief 精简CST，将其转换为RST
  *
@@ -262,8 +379,8 @@ pst_tree_ptr_t ExtendedSimpleLR1Parser::reduceCST()
     // 这里并不是在原来的CST上进行修改，而是在遍历CST的过程中挑选有用的信息构建新的RST
     stack<pst_node_ptr_t> rstStk;
     // 后序遍历CST，同时利用栈保存遍历过程中的节点，自底向上构建RST
-    cst->postorder(
-        [&](pst_node_t node)
+    getCST()->postorder(
+        [&](const pst_node_t &node)
         {
             // 创建新的RST节点
             pst_node_ptr_t rstNode = pst_tree_t::createNode(node.data);
@@ -273,8 +390,8 @@ pst_tree_ptr_t ExtendedSimpleLR1Parser::reduceCST()
             if (node.data.type == NON_TERM)
             {
                 assert(node.data.product_opt.has_value());
-                product_t &product = node.data.product_opt.value();
-                symstr_t &right = product.second;
+                const product_t &product = node.data.product_opt.value();
+                const symstr_t &right = product.second;
                 rstNode->attachProduct(product);
                 // 如果产生式右部只有一个终结符，那么将其作为RST节点的数据保留
                 if (right.size() == 1 && _find(terminals, right[0]))
@@ -323,22 +440,16 @@ void refactorStarListNode(pst_node_ptr_t astNode, vector<size_t> indexes)
         pst_node_ptr_t listNode = pst_tree_t::createNode(target->data);
         // 新节点的命名为StarList，便于后续处理
         listNode->data.symbol = "StarList";
-        // 递归遍历子节点
-        function<void(pst_node_ptr_t)> traverse = [&](pst_node_ptr_t node)
+        // 沿右递归的子结点向下，将各层的非右递归子节点直接平铺添加到新的节点中
+        // 右递归的层数与列表长度相同，这里用循环代替递归，避免长列表耗尽调用栈
+        for (pst_node_ptr_t node = target; node->hasChild(); node = node->lastChild())
         {
             const vector<pst_node_ptr_t> &children = node->getChildren();
-            if (children.size() > 0)
+            for (size_t i = 0; i + 1 < children.size(); i++)
             {
-                // 将各层的非右递归子节点直接平铺添加的要处理的根节点中
-                for (int i = 0; i < children.size() - 1; i++)
-                {
-                    *listNode << children[i];
-                }
-                // 在右递归的子结点中，最后一个子结点还是右递归的子结点
-                traverse(children.back());
+                *listNode << children[i];
             }
-        };
-        traverse(target);
+        }
         // 用新节点替换原来的节点
         astNode->replace(idx, listNode);
         // 下面进行AST简化整合
@@ -406,7 +517,7 @@ pst_tree_ptr_t ExtendedSimpleLR1Parser::refactorRST()
     stack<pst_node_ptr_t> astStk;
     // 后序遍历RST，同时利用栈保存遍历过程中的节点，自底向上构建AST
     rst->postorder(
-        [&](pst_node_t node)
+        [&](const pst_node_t &node)
         {
             // 创建新的AST节点
             pst_node_ptr_t astNode = pst_tree_t::createNode(node.data);
@@ -417,7 +528,7 @@ pst_tree_ptr_t ExtendedSimpleLR1Parser::refactorRST()
             if (node.data.type == NON_TERM)
             {
                 assert(node.data.product_opt.has_value());
-                product_t &product = node.data.product_opt.value();
+                const product_t &product = node.data.product_opt.value();
                 // 将产生式简化为仅包含有用信息的产生式
                 reduced_product_t reducedProduct = grammar.reduceProduct(product);
                 symbol_t &left = reducedProduct.first;
@@ -464,4 +575,72 @@ pst_tree_ptr_t ExtendedSimpleLR1Parser::refactorRST()
     // 最后栈中只剩下一个AST节点，即为最终的AST
     ast = astStk.top();
     return ast;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 预处理直接构建AST时各产生式的规则，与reduceCST、refactorRST逐结点的判断一致：
+ * 保留的子结点即Grammar::reduceProduct保留的符号，特殊非终结符的位置按精简后的右部计算，
+ * 且与refactorRST一样按从右到左的顺序记录
+ */
+void ExtendedSimpleLR1Parser::calcASTRules()
+{
+    astRules.clear();
+    for (auto &product : grammar.products)
+    {
+        ast_rule_t rule;
+        const symstr_t &right = product.second;
+        bool single = right.size() == 1 && _find(grammar.terminals, right[0]);
+        symstr_t reduced;
+        for (auto &s : right)
+        {
+            bool keep = single || _find(grammar.nonTerms, s) || _find(grammar.mulTerms, s);
+            rule.keep.push_back(keep);
+            if (keep)
+                reduced.push_back(s);
+        }
+        for (size_t i = reduced.size() - 1; i != -1; i--)
+        {
+            if (reduced[i].find("_star_") != string::npos)
+                rule.starIndexes.push_back(i);
+            else if (reduced[i].find("_opti_") != string::npos)
+                rule.optiIndexes.push_back(i);
+        }
+        rule.starLeft = product.first.find("_star_") != string::npos;
+        astRules.push_back(rule);
+    }
+}
+
+/**
+ * @brief 规约时直接构建AST结点，效果等同于对该结点依次执行reduceCST和refactorRST中的处理
+ *
+ * @param p 产生式编号
+ * @param cstKids 子结点在连续存储的CST中的编号，用于创建被保留的终结符结点
+ * @param astKids 子结点对应的AST结点，终结符为空指针
+ * @param input 紧凑词法单元序列
+ * @return pst_node_ptr_t 新的AST结点
+ */
+pst_node_ptr_t ExtendedSimpleLR1Parser::reduceAST(
+    size_t p, span<const arena_node_id_t> cstKids, const pst_node_ptr_t *astKids, const TokenStream &input)
+{
+    product_t &product = grammar.products[p];
+    const ast_rule_t &rule = astRules[p];
+    pst_node_ptr_t node = pst_tree_t::createNode(NON_TERM, product.first, 0, 0);
+    node->attachProduct(product);
+    for (size_t i = 0; i < rule.keep.size(); i++)
+    {
+        if (!rule.keep[i])
+            continue;
+        pst_node_ptr_t child = astKids[i];
+        if (child == nullptr)
+        {
+            token tok = input.at(arena[cstKids[i]].token);
+            child = pst_tree_t::createNode(TERMINAL, tok.value, tok.line, tok.col);
+        }
+        *node << child;
+    }
+    if (rule.optiIndexes.size() > 0)
+        refactorOptionalNode(node, rule.optiIndexes);
+    if (!rule.starLeft && rule.starIndexes.size() > 0)
+        refactorStarListNode(node, rule.starIndexes);
+    return node;
+}
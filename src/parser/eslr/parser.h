@@ -18,26 +18,70 @@
  */
 
 #include "common/tree/pst.h"
+#include "common/tree/arena.h"
 #include "common/gram/slr1.h"
+#include "common/gram/lrtbl.h"
+#include "common/tok_stream.h"
+#include "parser/trace.h"
+#include "parser/tok_pipe.h"
 #include "utils/view/ctx_view.h"
 
 class ExtendedSimpleLR1Parser
 {
     SLR1Grammar grammar;
-    pst_tree_ptr_t cst; // Concrete Syntax Tree
-    pst_tree_ptr_t rst; // Reduced Syntax Tree
-    pst_tree_ptr_t ast; // Abstract Syntax Tree
+    bool compressed = false; // 是否使用行位移压缩的分析表
+    PackedLRTable lrTable;   // 冻结后的分析表，首次以紧凑词法单元序列分析时生成
+    CombLRTable combTable;   // 压缩后的分析表，同上
+    pst_tree_ptr_t cst;      // Concrete Syntax Tree
+    ArenaTree arena;         // 以紧凑词法单元序列分析时建立的CST，cst在需要时由其转换得到
+    std::optional<TokenStream> arenaTokens;
+    pst_tree_ptr_t rst;      // Reduced Syntax Tree
+    pst_tree_ptr_t ast;      // Abstract Syntax Tree
+    ParseTracer tracer;      // 分析过程跟踪，只作用于以词法单元序列分析的过程
+    bool directAST = false;  // 以紧凑词法单元序列分析时是否在规约的同时直接构建AST
+
+    // 直接构建AST时单个产生式的处理规则
+    struct ast_rule_t
+    {
+        std::vector<bool> keep;          // 右部各符号的结点是否保留（即RST中的子结点）
+        std::vector<size_t> starIndexes; // 保留的子结点中_star_结点的位置，从右到左
+        std::vector<size_t> optiIndexes; // 保留的子结点中_opti_结点的位置，从右到左
+        bool starLeft;                   // 左部是否为_star_非终结符
+    };
+    std::vector<ast_rule_t> astRules;
+    void calcASTRules();
+    pst_node_ptr_t reduceAST(size_t p, std::span<const arena_node_id_t> cstKids,
+                             const pst_node_ptr_t *astKids, const TokenStream &input);
     std::pair<std::string, std::string> descAction(const action_t &act) const;
+    void freezeTables();
+    template <typename next_fn_t>
+    bool parseWith(next_fn_t next, const TokenStream &input, const ContextViewer &code, size_t sizeHint);
 
 public:
-    ExtendedSimpleLR1Parser(SLR1Grammar &grammar) : grammar(grammar)
+    ExtendedSimpleLR1Parser(SLR1Grammar &grammar, trace_level_t trace = TRACE_FULL)
+        : grammar(grammar), tracer("ExtendedSimpleLR1Parser", trace)
+    {
+        cst = pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0);
+    }
+    // 使用预先冻结的分析表，不再构造LR项目集，只支持以紧凑词法单元序列分析
+    ExtendedSimpleLR1Parser(const Grammar &grammar, const PackedLRTable &table, trace_level_t trace = TRACE_FULL)
+        : lrTable(table), tracer("ExtendedSimpleLR1Parser", trace)
     {
+        static_cast<Grammar &>(this->grammar) = grammar;
         cst = pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0);
     }
     bool parse(std::vector<token> &input, const ContextViewer &code);
+    bool parse(const TokenStream &input, const ContextViewer &code);
+    // 边词法分析边语法分析，不预先生成词法单元序列；CST与以紧凑词法单元序列分析的结果相同
+    bool parse(const Lexer &lexer, const Viewer &code, bool async = true);
+    void useCompressedTable(bool enable = true) { compressed = enable; }
+    // 开启后以紧凑词法单元序列分析时直接得到AST，不构建RST；CST仍可通过getCST()获取
+    void useDirectAST(bool enable = true) { directAST = enable; }
+    void setTraceObserver(std::shared_ptr<ParseObserver> observer) { tracer.setObserver(observer); }
     pst_tree_ptr_t reduceCST();
     pst_tree_ptr_t refactorRST();
-    pst_tree_ptr_t getCST() { return cst; }
+    pst_tree_ptr_t getCST();
+    const ArenaTree &getArenaCST() const { return arena; }
     pst_tree_ptr_t getRST() { return rst; }
     pst_tree_ptr_t getAST() { return ast; }
 };
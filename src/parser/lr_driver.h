@@ -0,0 +1,121 @@
+/**
+ * @file lr_driver.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Table-driven LR Parsing Loop
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 只读取紧凑分析表的LR分析主循环
+ * 输入为以终结符编号表示的符号串（末尾为结束符号），栈中只保存状态号
+ * 语法树等语义值的构建通过回调交给调用者，分析循环本身不做任何字符串操作
+ * 分析表只需提供 action(s, t)、go(s, v)、productLength(p)、productLeft(p) 四个接口
+ * 输入既可以是预先转换好的符号串，也可以是按需拉取符号的回调（见driveLRPull）
+ */
+
+#pragma once
+
+#include "common/tok_stream.h"
+#include "common/gram/lrtbl.h"
+
+#include <vector>
+#include <cstdint>
+
+constexpr size_t LR_ACCEPTED = SIZE_MAX;
+
+// 词法单元类型编号 -> 分析表终结符编号，不属于文法的类型记为SYM_NONE
+inline std::vector<sym_id_t> lrSymbolMap(const SymbolInterner &symtab)
+{
+    std::vector<sym_id_t> tok2sym(tokTypeCount(), SYM_NONE);
+    for (tok_id_t i = 0; i < tok2sym.size(); i++)
+        tok2sym[i] = symtab.id(*tokTypeOf(i));
+    return tok2sym;
+}
+
+/**
+ * @brief 将紧凑词法单元序列转换为分析表的终结符编号序列，末尾追加结束符号
+ * 不属于文法的词法单元记为SYM_NONE，分析时按错误处理
+ */
+inline std::vector<sym_id_t> lrInput(const TokenStream &tokens, const SymbolInterner &symtab)
+{
+    std::vector<sym_id_t> tok2sym = lrSymbolMap(symtab);
+    std::vector<sym_id_t> input;
+    input.reserve(tokens.size() + 1);
+    for (size_t i = 0; i < tokens.size(); i++)
+        input.push_back(tok2sym[tokens.typeId(i)]);
+    input.push_back(symtab.id(SYM_END));
+    return input;
+}
+
+/**
+ * @brief 以拉取方式读入符号的LR分析主循环
+ * 分析程序每移进一个符号才向输入源要下一个符号，输入源可以是边分析边进行的词法分析
+ *
+ * @param table 分析表
+ * @param next 取下一个终结符编号 next()，输入结束后应返回结束符号，返回SYM_NONE按错误处理
+ * @param onShift 移进第i个输入符号时调用 onShift(i)
+ * @param onReduce 按产生式p规约时调用 onReduce(p)，调用者需弹出其右部长度个语义值
+ * @return size_t 接受时返回LR_ACCEPTED，否则返回出错位置
+ */
+template <typename table_t, typename next_fn_t, typename shift_fn_t, typename reduce_fn_t>
+size_t driveLRPull(const table_t &table, next_fn_t next, shift_fn_t onShift, reduce_fn_t onReduce)
+{
+    std::vector<state_id_t> states;
+    states.reserve(64);
+    states.push_back(0);
+    size_t i = 0;
+    sym_id_t look = next();
+    while (look != SYM_NONE)
+    {
+        auto act = table.action(states.back(), look);
+        switch (lrKind(act))
+        {
+        case LR_SHIFT:
+            states.push_back(lrValue(act));
+            onShift(i++);
+            look = next();
+            break;
+        case LR_REDUCE:
+        {
+            size_t p = lrValue(act);
+            states.resize(states.size() - table.productLength(p));
+            auto go = table.go(states.back(), table.productLeft(p));
+            onReduce(p);
+            if (lrKind(go) == LR_ACCEPT)
+                return LR_ACCEPTED;
+            if (lrKind(go) != LR_SHIFT)
+                return i;
+            states.push_back(lrValue(go));
+            break;
+        }
+        case LR_ACCEPT:
+            return LR_ACCEPTED;
+        default:
+            return i;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief LR分析主循环
+ *
+ * @param table 分析表
+ * @param input 终结符编号序列
+ * @param onShift 移进第i个输入符号时调用 onShift(i)
+ * @param onReduce 按产生式p规约时调用 onReduce(p)，调用者需弹出其右部长度个语义值
+ * @return size_t 接受时返回LR_ACCEPTED，否则返回出错位置
+ */
+template <typename table_t, typename shift_fn_t, typename reduce_fn_t>
+size_t driveLR(const table_t &table, const std::vector<sym_id_t> &input, shift_fn_t onShift, reduce_fn_t onReduce)
+{
+    size_t k = 0;
+    auto next = [&]()
+    {
+        return k < input.size() ? input[k++] : SYM_NONE;
+    };
+    return driveLRPull(table, next, onShift, onReduce);
+}
@@ -10,18 +10,13 @@
 
 #include "utils/log.h"
 #include "utils/stl.h"
-#include "utils/table.h"
 #include "utils/view/tok_view.h"
 #include "parser.h"
 
-#include <stack>
-
 using namespace std;
 
 #define DEBUG_LEVEL 0
 
-using namespace table;
-
 #define _isVT(t) _find(grammar.terminals, t)
 #define _isVN(t) _find(grammar.nonTerms, t)
 #define _lt(t1, t2) (grammar.opt[mkcrd(t1, t2)] == OP::LT)
@@ -74,20 +69,16 @@ bool OperatorPrecedenceGrammarParser::parse(vector<token> &input)
     TokenViewer viewer(input);
     vector<symbol_t> stk;
     stk.push_back(SYM_END);
-    tb_head | "Stack" | "Priority" | "Input" | MD_TAB | "Action";
-    set_col | AL_LFT | AL_CTR | AL_RGT | AL_RGT | AL_LFT;
+    tracer.begin({"Stack", "Priority", "Input", "Action", "Product"});
     while (!stk.empty() && !viewer.ends())
     {
         assert(stk.size() >= 1, "OPGParser: invalid stack.");
         int cursor = stk.size() - 1;
         symbol_t top = stk.back();
         symbol_t cur = *(viewer.current().type);
-        new_row | compact(stk);
         if (top == grammar.symStart && cur == SYM_END)
         {
-            tb_line(-1);
-            tb_cont | TB_TAB | TB_TAB | MD_TAB | "Accepted" = table::FORE_GRE;
-            cout << tb_view();
+            tracer.end(true, tracer.full() ? compact(stk) : "");
             info << "OPGParser: parsing succeeded." << endl;
             return true;
         }
@@ -99,11 +90,15 @@ bool OperatorPrecedenceGrammarParser::parse(vector<token> &input)
         }
         if (!_gt(top, cur))
         {
-            tb_cont | top + (grammar.opt[mkcrd(top, cur)] == OP::LT ? "<" : "=") + cur;
-            tb_cont | compact(viewer.restTypes());
-            tb_cont | "Shift" | cur;
+            tracer.step(
+                [&]()
+                {
+                    string priority = top + (grammar.opt[mkcrd(top, cur)] == OP::LT ? "<" : "=") + cur;
+                    return vector<string>{compact(stk), priority, compact(viewer.restTypes()), "Shift", cur};
+                });
             stk.push_back(cur);
             viewer.advance();
+            tracer.advance();
         }
         else
         {
@@ -119,14 +114,18 @@ bool OperatorPrecedenceGrammarParser::parse(vector<token> &input)
                 if (_lt(now, top))
                 {
                     symstr_t right(stk.begin() + cursor + 1, stk.end());
-                    tb_cont | now + "<" + top + ">" + cur | compact(viewer.restTypes());
-                    stk.erase(stk.begin() + cursor + 1, stk.end());
                     symbol_t left = findLeft(right, grammar);
-                    tb_cont | "Reduce" | left + "->" + compact(right);
+                    tracer.step(
+                        [&]()
+                        {
+                            return vector<string>{compact(stk), now + "<" + top + ">" + cur,
+                                                  compact(viewer.restTypes()), "Reduce", left + "->" + compact(right)};
+                        });
+                    stk.erase(stk.begin() + cursor + 1, stk.end());
                     if (left == "")
                     {
                         error << "Product " << now << "->" << compact(right) << " not found." << endl;
-                        cout << tb_view();
+                        tracer.end(false);
                         return false;
                     }
                     stk.push_back(left);
@@ -137,7 +136,7 @@ bool OperatorPrecedenceGrammarParser::parse(vector<token> &input)
             }
         }
     }
-    cout << tb_view();
+    tracer.end(false);
     info << "OPGParser: parsing failed." << endl;
     return false;
 }
\ No newline at end of file
@@ -10,16 +10,20 @@
 
 #include "common/gram/opg.h"
 #include "common/tree/pst.h"
+#include "parser/trace.h"
 
 class OperatorPrecedenceGrammarParser
 {
 public:
     OperatorPrecedenceGrammar grammar;
     pst_tree_ptr_t cst;
-    OperatorPrecedenceGrammarParser(OperatorPrecedenceGrammar &grammar) : grammar(grammar)
+    ParseTracer tracer;
+    OperatorPrecedenceGrammarParser(OperatorPrecedenceGrammar &grammar, trace_level_t trace = TRACE_FULL)
+        : grammar(grammar), tracer("OPGParser", trace)
     {
         cst = pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0);
     }
     bool parse(std::vector<token> &input);
+    void setTraceObserver(std::shared_ptr<ParseObserver> observer) { tracer.setObserver(observer); }
     pst_tree_ptr_t getCST() { return cst; }
 };
\ No newline at end of file
@@ -10,19 +10,27 @@
 
 #include "common/tree/pst.h"
 #include "common/gram/slr1.h"
+#include "common/gram/lrtbl.h"
+#include "common/tok_stream.h"
+#include "parser/trace.h"
 #include "utils/view/ctx_view.h"
 
 class SimpleLR1Parser
 {
     SLR1Grammar grammar;
+    CombLRTable lrTable; // 压缩后的分析表，首次以紧凑词法单元序列分析时生成
     pst_tree_ptr_t cst;
+    ParseTracer tracer;
     std::pair<std::string, std::string> descAction(const action_t &act) const;
 public:
-    SimpleLR1Parser(SLR1Grammar &grammar) : grammar(grammar)
+    SimpleLR1Parser(SLR1Grammar &grammar, trace_level_t trace = TRACE_FULL)
+        : grammar(grammar), tracer("SimpleLR1Parser", trace)
     {
         cst = pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0);
     }
     bool parse(std::vector<token> &input, const ContextViewer &code);
+    bool parse(const TokenStream &input, const ContextViewer &code);
+    void setTraceObserver(std::shared_ptr<ParseObserver> observer) { tracer.setObserver(observer); }
     pst_tree_ptr_t getCST() { return cst; }
 };
 
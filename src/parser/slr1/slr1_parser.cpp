@@ -9,32 +9,12 @@
  */
 
 #include "parser.h"
-#include "utils/table.h"
+#include "parser/lr_driver.h"
 #include "utils/view/tok_view.h"
 
 #include <stack>
 
 using namespace std;
-using namespace table;
-
-template <typename T>
-string descStack(stack<T> s, int limit = 8)
-{
-    stringstream ss;
-    symstr_t v;
-    while (!s.empty() && limit--)
-    {
-        stringstream t;
-        t << s.top();
-        v.push_back(t.str());
-        s.pop();
-    }
-    if (limit <= 0)
-        v.push_back("...");
-    reverse(v.begin(), v.end());
-    ss << container2str(v, " ", "");
-    return ss.str();
-}
 
 pair<string, string> SimpleLR1Parser::descAction(const action_t &act) const
 {
@@ -83,60 +63,60 @@ bool SimpleLR1Parser::parse(vector<token> &input, const ContextViewer &code)
     // 初始化状态
     input.push_back(token(make_shared<symbol_t>(SYM_END), SYM_END, 0, 0));
     TokenViewer viewer(input);
-    // 初始化栈
-    stack<symbol_t> symStk;       // 符号栈
-    stack<state_id_t> stateStk;   // 状态栈
+    // 初始化栈（末尾为栈顶）
+    vector<symbol_t> symStk;      // 符号栈
+    vector<state_id_t> stateStk;  // 状态栈
     stack<pst_node_ptr_t> cstStk; // 语法树栈
-    symStk.push(SYM_END);
-    stateStk.push(0);
-    // 初始化表格
-    tb_head | "Symbol/State" | "Input" | "Action";
-    set_row | AL_CTR;
+    symStk.push_back(SYM_END);
+    stateStk.push_back(0);
+    tracer.begin({"Symbol/State", "Input", "Action"});
     token &tok = viewer.current();
     while (!stateStk.empty() && !symStk.empty() && !viewer.ends())
     {
         tok = viewer.current();
-        state_id_t s = stateStk.top();
-        symbol_t a = *(tok.type);
+        state_id_t s = stateStk.back();
+        const symbol_t &a = *(tok.type);
         action_t &act = grammar.slr1Table[mkcrd(s, a)];
-        string act1, act2;
-        tie(act1, act2) = descAction(act);
-        new_row | Cell(descStack(symStk)) & AL_LFT | Cell(a) & AL_LFT | Cell(act1) & AL_LFT;
-        new_row | descStack(stateStk) | Cell(descTokVecFrom(input, viewer.pos())) & AL_RGT | Cell(act2) & AL_RGT;
-        tb_line();
+        tracer.step(
+            [&]()
+            {
+                auto [act1, act2] = descAction(act);
+                return vector<string>{descStack(symStk, 8), a, act1,
+                                      descStack(stateStk, 8), descTokVecFrom(input, viewer.pos()), act2};
+            });
         if (holds_alternative<shift_t>(act))
         {
             // 移进动作
             shift_t shift = get<shift_t>(act);
-            symStk.push(a);
-            stateStk.push(shift);
+            symStk.push_back(a);
+            stateStk.push_back(shift);
             pst_node_ptr_t node = pst_tree_t::createNode(TERMINAL, tok.value, tok.line, tok.col);
             cstStk.push(node);
             viewer.advance();
+            tracer.advance();
         }
         else if (holds_alternative<reduce_t>(act))
         {
             // 规约动作
             product_t &reduce = get<reduce_t>(act).get();
-            symbol_t left = reduce.first;
-            symstr_t right = reduce.second;
-            size_t len = right.size();
+            const symbol_t &left = reduce.first;
+            size_t len = reduce.second.size();
             pst_node_ptr_t node = pst_tree_t::createNode(NON_TERM, left, 0, 0);
             vector<pst_node_ptr_t> children;
             for (size_t i = 0; i < len; i++)
             {
-                symStk.pop();
-                stateStk.pop();
                 children.push_back(cstStk.top());
                 cstStk.pop();
             }
+            symStk.resize(symStk.size() - len);
+            stateStk.resize(stateStk.size() - len);
             for (auto it = children.rbegin(); it != children.rend(); it++)
                 *node << *it;
-            symStk.push(left);
+            symStk.push_back(left);
             cstStk.push(node);
-            action_t &nAct = grammar.slr1Table[mkcrd(stateStk.top(), left)];
+            action_t &nAct = grammar.slr1Table[mkcrd(stateStk.back(), left)];
             if (holds_alternative<shift_t>(nAct))
-                stateStk.push(get<shift_t>(nAct));
+                stateStk.push_back(get<shift_t>(nAct));
             else if (holds_alternative<accept_t>(nAct) && get<accept_t>(nAct))
                 goto accept;
             else
@@ -149,8 +129,7 @@ bool SimpleLR1Parser::parse(vector<token> &input, const ContextViewer &code)
     }
 reject:
     error << "SimpleLR1Parser: Parsing failed!" << endl;
-    new_row | TB_TAB | MD_TAB | Cell("Rejected") & FORE_RED;
-    std::cout << tb_view();
+    tracer.end(false);
     info << "SimpleLR1Parser: Related context:" << endl;
     tok = viewer.current();
     code.printContext(tok.line, tok.col);
@@ -159,20 +138,65 @@ reject:
     return false;
 accept:
     info << "SimpleLR1Parser: Parsing succeed!" << endl;
-    symstr_t right = *(grammar.rules[grammar.symStart].begin());
+    size_t len = grammar.rules[grammar.symStart].begin()->size();
     pst_node_ptr_t startNode = pst_tree_t::createNode(NON_TERM, grammar.symStart, 0, 0);
     vector<pst_node_ptr_t> children;
-    for (size_t i = 0; i < right.size(); i++)
+    for (size_t i = 0; i < len; i++)
     {
-        symStk.pop();
-        stateStk.pop();
         children.push_back(cstStk.top());
         cstStk.pop();
     }
+    symStk.resize(symStk.size() - len);
+    stateStk.resize(stateStk.size() - len);
     for (auto it = children.rbegin(); it != children.rend(); it++)
         *startNode << *it;
     cst = startNode;
-    new_row | Cell(descStack(symStk)) & AL_LFT | MD_TAB | Cell("Accepted") & FORE_GRE;
-    std::cout << tb_view();
+    tracer.end(true, tracer.full() ? descStack(symStk, 8) : "");
     return true;
-}
\ No newline at end of file
+}
+
+bool SimpleLR1Parser::parse(const TokenStream &input, const ContextViewer &code)
+{
+    info << "SimpleLR1Parser: Parsing with compressed table..." << endl;
+    if (lrTable.size() == 0)
+        lrTable = CombLRTable(grammar);
+    vector<pst_node_ptr_t> cstStk;
+    auto onShift = [&](size_t i)
+    {
+        token tok = input.at(i);
+        cstStk.push_back(pst_tree_t::createNode(TERMINAL, tok.value, tok.line, tok.col));
+    };
+    auto onReduce = [&](size_t p)
+    {
+        size_t len = lrTable.productLength(p);
+        pst_node_ptr_t node = pst_tree_t::createNode(NON_TERM, grammar.products[p].first, 0, 0);
+        for (size_t i = cstStk.size() - len; i < cstStk.size(); i++)
+            *node << cstStk[i];
+        cstStk.resize(cstStk.size() - len);
+        cstStk.push_back(node);
+    };
+    size_t errPos = driveLR(lrTable, lrInput(input, lrTable.symtab), onShift, onReduce);
+    if (errPos != LR_ACCEPTED)
+    {
+        error << "SimpleLR1Parser: Parsing failed!" << endl;
+        info << "SimpleLR1Parser: Related context:" << endl;
+        if (errPos < input.size())
+        {
+            auto lc = input.lineCol(errPos);
+            code.printContext(lc.first, lc.second);
+        }
+        info << "SimpleLR1Parser: Remaining cst nodes:" << endl;
+        stack<pst_node_ptr_t> pstStk;
+        for (auto &node : cstStk)
+            pstStk.push(node);
+        printRemainingTreeNodes(pstStk);
+        return false;
+    }
+    info << "SimpleLR1Parser: Parsing succeed!" << endl;
+    size_t len = grammar.rules[grammar.symStart].begin()->size();
+    pst_node_ptr_t startNode = pst_tree_t::createNode(NON_TERM, grammar.symStart, 0, 0);
+    for (size_t i = cstStk.size() - len; i < cstStk.size(); i++)
+        *startNode << cstStk[i];
+    cst = startNode;
+    return true;
+}
@@ -10,22 +10,26 @@
 
 #include "common/tree/pst.h"
 #include "common/gram/predict.h"
+#include "parser/trace.h"
 
 class StackPredictiveTableParser
 {
     PredictiveGrammar grammar;
     pst_tree_ptr_t cst;
+    ParseTracer tracer;
     table_t<symbol_t, symbol_t, symstr_t> predict;
     void calcPredictTable();
 
 public:
-    StackPredictiveTableParser(PredictiveGrammar g) : grammar(g)
+    StackPredictiveTableParser(PredictiveGrammar g, trace_level_t trace = TRACE_FULL)
+        : grammar(g), tracer("StackPredictiveTableParser", trace)
     {
         cst = pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0);
         calcPredictTable();
     }
     void printPredictTable() const;
     bool parse(std::vector<token> input);
+    void setTraceObserver(std::shared_ptr<ParseObserver> observer) { tracer.setObserver(observer); }
     pst_tree_ptr_t getCST() const { return cst; }
 };
 
@@ -14,7 +14,6 @@
 #include "utils/table.h"
 #include "utils/view/tok_view.h"
 
-#include <stack>
 
 using namespace std;
 using namespace table;
@@ -79,50 +78,46 @@ void StackPredictiveTableParser::printPredictTable() const
     cout << tb_view() << std::endl;
 }
 
-#define top_sym(s) ((s.top())->data.symbol)
+// 分析栈以vector保存，末尾为栈顶
+#define top_sym(s) ((s.back())->data.symbol)
 
-string descStack(stack<pst_node_ptr_t> s)
+string descStack(const vector<pst_node_ptr_t> &s)
 {
-    stringstream ss;
     symstr_t v;
-    while (!s.empty())
-    {
-        v.push_back(top_sym(s));
-        s.pop();
-    }
-    reverse(v.begin(), v.end());
-    ss << vec2str(v);
-    return ss.str();
+    for (auto &node : s)
+        v.push_back(node->data.symbol);
+    return vec2str(v);
 }
 
 bool StackPredictiveTableParser::parse(vector<token> input)
 {
-    stack<pst_node_ptr_t> s;
+    vector<pst_node_ptr_t> s;
     input.push_back(token(make_shared<symbol_t>(SYM_END), SYM_END, 0, 0));
     TokenViewer viewer(input);
-    s.push(pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0));
+    s.push_back(pst_tree_t::createNode(TERMINAL, SYM_END, 0, 0));
     pst_node_ptr_t startNode = pst_tree_t::createNode(NON_TERM, grammar.symStart, 0, 0);
-    s.push(startNode);
-    tb_head | "Analyze Stack" | "Remaining Input" | "Action";
-    set_col | AL_LFT | AL_RGT | AL_RGT;
-    new_row | descStack(s) | descTokVecFrom(input, 0) | "Initial";
+    s.push_back(startNode);
+    tracer.begin({"Analyze Stack", "Remaining Input", "Action"});
+    tracer.step([&]()
+                { return vector<string>{descStack(s), descTokVecFrom(input, 0), "Initial"}; });
     while (top_sym(s) != SYM_END && !viewer.ends())
     {
         token &cur = viewer.current();
-        size_t idx = viewer.pos();
         string actionDesc;
         symbol_t curSym = top_sym(s);
-        symbol_t curType = *(cur.type);
+        const symbol_t &curType = *(cur.type);
         assert(_find(grammar.terminals, curType));
         if (curSym == curType)
         {
-            pst_node_ptr_t topNode = s.top();
+            pst_node_ptr_t topNode = s.back();
             topNode->data.symbol = cur.value;
             topNode->data.line = cur.line;
             topNode->data.col = cur.col;
-            s.pop();
+            s.pop_back();
             viewer.advance();
-            actionDesc = "Matched " + cur.value;
+            tracer.advance();
+            if (tracer.full())
+                actionDesc = "Matched " + cur.value;
         }
         else if (_find(grammar.nonTerms, curSym))
         {
@@ -130,15 +125,15 @@ bool StackPredictiveTableParser::parse(vector<token> input)
             if (predict.find(crd) != predict.end())
             {
                 symstr_t &right = predict[crd];
-                pst_node_ptr_t topNode = s.top();
-                s.pop();
+                pst_node_ptr_t topNode = s.back();
+                s.pop_back();
                 vector<pst_node_ptr_t> children;
                 for (auto it1 = right.rbegin(); it1 != right.rend(); it1++)
                 {
                     node_type type = _find(grammar.terminals, *it1) ? TERMINAL : NON_TERM;
                     pst_node_ptr_t newNode = pst_tree_t::createNode(type, *it1, 0, 0);
                     children.push_back(newNode);
-                    s.push(newNode);
+                    s.push_back(newNode);
                 }
                 // 保证树节点的顺序
                 for (auto it1 = children.rbegin(); it1 != children.rend(); it1++)
@@ -150,14 +145,15 @@ bool StackPredictiveTableParser::parse(vector<token> input)
                     // 空串
                     *(topNode) << pst_tree_t::createNode(TERMINAL, EPSILON, 0, 0);
                 }
-                actionDesc = curType + " -> " + compact(right);
+                if (tracer.full())
+                    actionDesc = curType + " -> " + compact(right);
             }
             else
             {
                 error << format(
                     "StackPredictiveTableParser: Unexpected token: $ at <$, $>.\n",
                     cur.value, cur.line, cur.col);
-                cout << tb_view();
+                tracer.end(false);
                 return false;
             }
         }
@@ -166,15 +162,14 @@ bool StackPredictiveTableParser::parse(vector<token> input)
             error << format(
                 "StackPredictiveTableParser: Unexpected token: $ at <$, $>.\n",
                 cur.value, cur.line, cur.col);
-            cout << tb_view();
+            tracer.end(false);
             return false;
         }
-        new_row | descStack(s) | descTokVecFrom(input, viewer.pos()) | actionDesc;
+        tracer.step([&]()
+                    { return vector<string>{descStack(s), descTokVecFrom(input, viewer.pos()), actionDesc}; });
     }
-    tb_line();
-    new_row | TB_TAB | MD_TAB | "Accepted";
     info << "Analyze finished." << std::endl;
-    cout << tb_view();
+    tracer.end(true);
     info << "Parse Tree: " << std::endl;
     cst = startNode;
     return true;
@@ -648,5 +648,8 @@ Grammar SyntaxParser::parse(const string grammarPath)
     // 解析并添加优先级和结合性
     addPrecAndAssoc();
 
+    // 为所有文法符号分配整数编号
+    grammar.internSymbols();
+
     return grammar;
 }
@@ -0,0 +1,134 @@
+/**
+ * @file tok_pipe.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Streaming Lexer-to-Parser Token Pipe
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "tok_pipe.h"
+#include "parser/lr_driver.h"
+#include "utils/log.h"
+
+using namespace std;
+
+TokenPipe::TokenPipe(const Lexer &lexer, const Grammar &grammar, const SymbolInterner &symtab,
+                     const Viewer &code, bool async)
+    : lexer(lexer), mapper(grammar), out(code), input(out.getSource()), async(async)
+{
+    // 映射表构造时可能登记新的类型编号，须在此之后生成终结符编号表
+    tok2sym = lrSymbolMap(symtab);
+    endSym = symtab.id(SYM_END);
+    if (async)
+        worker = thread(&TokenPipe::produce, this);
+}
+
+TokenPipe::~TokenPipe()
+{
+    if (worker.joinable())
+    {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+}
+
+/**
+ * @brief 扫描并映射一个词法单元
+ *
+ * @param span 映射后的词法单元
+ * @return true 取到了词法单元
+ * @return false 已到达源文本结尾
+ */
+bool TokenPipe::scan(token_span &span)
+{
+    tok_id_t type;
+    size_t offset, length;
+    if (!lexer.next(input, type, offset, length))
+        return false;
+    if (!mapper.map(type, input.getView().substr(offset, length)))
+        warn << "TokenPipe: Unknown token: " << input.getView().substr(offset, length) << endl;
+    span = {type, (uint32_t)offset, (uint32_t)length};
+    return true;
+}
+
+// 预读线程：逐块扫描，已有两块未被取走时等待
+void TokenPipe::produce()
+{
+    vector<token_span> buf;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [&]()
+                    { return stopping || ready.size() < 2; });
+            if (stopping)
+                return;
+            if (!spare.empty())
+            {
+                buf = move(spare.back());
+                spare.pop_back();
+            }
+        }
+        buf.clear();
+        buf.reserve(CHUNK_SIZE);
+        token_span span;
+        while (buf.size() < CHUNK_SIZE && scan(span))
+            buf.push_back(span);
+        bool last = buf.size() < CHUNK_SIZE;
+        {
+            lock_guard<mutex> lock(mtx);
+            ready.push_back(move(buf));
+            finished = last;
+        }
+        cv.notify_all();
+        if (last)
+            return;
+    }
+}
+
+bool TokenPipe::pull(token_span &span)
+{
+    if (!async)
+        return scan(span);
+    while (chunkPos == chunk.size())
+    {
+        unique_lock<mutex> lock(mtx);
+        if (chunk.capacity() > 0)
+            spare.push_back(move(chunk));
+        cv.wait(lock, [&]()
+                { return !ready.empty() || finished; });
+        if (ready.empty())
+        {
+            chunk.clear();
+            chunkPos = 0;
+            return false;
+        }
+        chunk = move(ready.front());
+        ready.pop_front();
+        chunkPos = 0;
+        lock.unlock();
+        cv.notify_all();
+    }
+    span = chunk[chunkPos++];
+    return true;
+}
+
+sym_id_t TokenPipe::next()
+{
+    if (ended)
+        return SYM_NONE;
+    token_span span;
+    if (!pull(span))
+    {
+        ended = true;
+        return endSym;
+    }
+    out.push(span.type, span.offset, span.length);
+    return tok2sym[span.type];
+}
@@ -0,0 +1,72 @@
+/**
+ * @file tok_pipe.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Streaming Lexer-to-Parser Token Pipe
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 边词法分析边语法分析
+ * 语法分析程序每次向管道要一个终结符编号，管道向词法分析程序要下一个词法单元，
+ * 随即完成文法符号映射（TokenMapper）和终结符编号转换，不再先生成完整的词法单元序列再整体转换
+ * 异步模式下由预读线程逐块（CHUNK_SIZE个词法单元）扫描，最多领先分析程序两块，
+ * 词法分析与语法分析重叠进行，块的空间循环使用
+ * 已取出的词法单元以12字节的紧凑形式追加到TokenStream中，供语法树以下标引用，也用于出错时定位
+ */
+
+#pragma once
+
+#include "lexer/lexer.h"
+#include "common/gram/basic.h"
+#include "common/tok_stream.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+class TokenPipe
+{
+    static constexpr size_t CHUNK_SIZE = 4096; // 预读线程每次交付的词法单元个数
+
+    const Lexer &lexer;
+    TokenMapper mapper;
+    std::vector<sym_id_t> tok2sym; // 映射后的类型编号 -> 分析表终结符编号
+    sym_id_t endSym;
+    TokenStream out;     // 已取出的词法单元
+    ContextViewer input; // 词法分析的扫描位置，异步模式下只由预读线程使用
+    bool ended = false;  // 是否已交出结束符号
+
+    bool async;
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::vector<token_span>> ready; // 已扫描完成、等待取出的块
+    std::vector<std::vector<token_span>> spare; // 已取完、可供复用的块
+    std::vector<token_span> chunk;              // 正在取出的块
+    size_t chunkPos = 0;
+    bool finished = false; // 预读线程已扫描到源文本结尾
+    bool stopping = false; // 分析提前结束，通知预读线程退出
+
+    bool scan(token_span &span);
+    bool pull(token_span &span);
+    void produce();
+
+public:
+    TokenPipe(const Lexer &lexer, const Grammar &grammar, const SymbolInterner &symtab,
+              const Viewer &code, bool async = true);
+    ~TokenPipe();
+    TokenPipe(const TokenPipe &) = delete;
+    TokenPipe &operator=(const TokenPipe &) = delete;
+
+    // 取出下一个词法单元的终结符编号，源文本结束后返回结束符号，此后返回SYM_NONE
+    sym_id_t next();
+    // 已取出的词法单元，下标与分析程序移进的次序一致
+    const TokenStream &tokens() const { return out; }
+    // 交出已取出的词法单元，管道随后不应再使用
+    TokenStream release() { return std::move(out); }
+};
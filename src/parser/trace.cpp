@@ -0,0 +1,71 @@
+/**
+ * @file trace.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Parsing Trace Levels and Observers
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "trace.h"
+#include "utils/log.h"
+#include "utils/table.h"
+
+using namespace std;
+using namespace table;
+
+void TableTraceObserver::begin(const vector<string> &columns)
+{
+    this->columns = columns.size();
+    tb_head;
+    for (auto &col : columns)
+        tb_cont | col;
+    set_row | AL_CTR;
+}
+
+void TableTraceObserver::step(const vector<string> &cells)
+{
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (i % columns == 0)
+            new_row;
+        tb_cont | Cell(cells[i]) & AL_LFT;
+    }
+    // 多行描述的步骤之间用分割线隔开
+    if (cells.size() > columns)
+        tb_line();
+}
+
+void TableTraceObserver::end(bool accepted, const string &remark)
+{
+    tb_line();
+    new_row | (remark.empty() ? TB_TAB : remark);
+    for (size_t i = 2; i + 1 < columns; i++)
+        tb_cont | TB_TAB;
+    tb_cont | MD_TAB;
+    tb_cont | Cell(accepted ? "Accepted" : "Rejected") & (accepted ? FORE_GRE : FORE_RED);
+    cout << tb_view();
+}
+
+ParseTracer::ParseTracer(const string &name, trace_level_t level) : name(name), level(level)
+{
+    if (level == TRACE_FULL)
+        observer = make_shared<TableTraceObserver>();
+}
+
+void ParseTracer::setObserver(shared_ptr<ParseObserver> observer)
+{
+    this->observer = observer;
+    level = observer ? TRACE_FULL : TRACE_SUMMARY;
+}
+
+void ParseTracer::end(bool accepted, const string &remark)
+{
+    if (level >= TRACE_SUMMARY)
+        info << format("$: $ after $ steps, $ tokens consumed.",
+                       name, accepted ? "Accepted" : "Rejected", steps, consumed)
+             << endl;
+    if (observer)
+        observer->end(accepted, remark);
+}
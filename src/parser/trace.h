@@ -0,0 +1,112 @@
+/**
+ * @file trace.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Parsing Trace Levels and Observers
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 分析过程跟踪
+ * 分析程序在构造时选择跟踪级别：
+ * TRACE_OFF     不做任何描述，分析循环中没有字符串格式化，也不构建表格
+ * TRACE_SUMMARY 只统计步数和移进的词法单元数，分析结束时输出一行摘要
+ * TRACE_FULL    每一步都生成描述并交给观察者，默认的观察者将其渲染为分析过程表格
+ * 每一步的描述由分析程序以回调的形式给出，只有挂接了观察者时才会调用
+ */
+
+#pragma once
+
+#include "utils/stl.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <sstream>
+
+enum trace_level_t
+{
+    TRACE_OFF,
+    TRACE_SUMMARY,
+    TRACE_FULL,
+};
+
+/**
+ * @brief 分析过程观察者
+ * begin给出各列的列名；step给出某一步各列的描述，其长度可以是列数的整数倍，此时分多行显示；
+ * end在分析结束时调用，remark为结束时的补充说明（如剩余的符号栈）
+ */
+class ParseObserver
+{
+public:
+    virtual ~ParseObserver() = default;
+    virtual void begin(const std::vector<std::string> &columns) = 0;
+    virtual void step(const std::vector<std::string> &cells) = 0;
+    virtual void end(bool accepted, const std::string &remark) = 0;
+};
+
+// 将分析过程渲染为表格，在分析结束时打印输出
+class TableTraceObserver : public ParseObserver
+{
+    size_t columns = 0;
+
+public:
+    void begin(const std::vector<std::string> &columns) override;
+    void step(const std::vector<std::string> &cells) override;
+    void end(bool accepted, const std::string &remark) override;
+};
+
+class ParseTracer
+{
+    std::string name;
+    trace_level_t level;
+    std::shared_ptr<ParseObserver> observer; // 仅TRACE_FULL级别下非空
+    size_t steps = 0, consumed = 0;
+
+public:
+    ParseTracer(const std::string &name, trace_level_t level = TRACE_FULL);
+    // 挂接自定义的观察者，同时将跟踪级别提升为TRACE_FULL；传入空指针则降为TRACE_SUMMARY
+    void setObserver(std::shared_ptr<ParseObserver> observer);
+    trace_level_t getLevel() const { return level; }
+    bool full() const { return observer != nullptr; }
+    void begin(const std::vector<std::string> &columns)
+    {
+        steps = consumed = 0;
+        if (observer)
+            observer->begin(columns);
+    }
+    // desc为生成该步描述的回调，只有挂接了观察者时才会调用
+    template <typename desc_fn_t>
+    void step(desc_fn_t desc)
+    {
+        steps++;
+        if (observer)
+            observer->step(desc());
+    }
+    void advance() { consumed++; }
+    void end(bool accepted, const std::string &remark = "");
+};
+
+/**
+ * @brief 将栈（以vector保存，末尾为栈顶）转换为字符串，栈顶在右
+ *
+ * @param s 栈
+ * @param limit 最多描述的元素个数，超出的部分（栈底一侧）以省略号代替
+ */
+template <typename T>
+std::string descStack(const std::vector<T> &s, size_t limit = SIZE_MAX)
+{
+    std::vector<std::string> v;
+    size_t from = s.size() > limit ? s.size() - limit : 0;
+    if (from > 0)
+        v.push_back("...");
+    for (size_t i = from; i < s.size(); i++)
+    {
+        std::stringstream ss;
+        ss << s[i];
+        v.push_back(ss.str());
+    }
+    return container2str(v, " ", "");
+}
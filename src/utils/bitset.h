@@ -0,0 +1,148 @@
+/**
+ * @file utils/bitset.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Dynamic Fixed-width Bitset
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+
+/**
+ * @brief 运行时确定宽度的位集合
+ * 宽度在构造时确定，之后不再改变，所有按位运算要求两个集合宽度相同
+ * 用于以整数编号表示的符号集合、项目集合等
+ */
+class Bitset
+{
+    size_t width = 0;
+    std::vector<uint64_t> words;
+
+public:
+    Bitset() = default;
+    Bitset(size_t width) : width(width), words((width + 63) / 64, 0) {}
+
+    size_t size() const
+    {
+        return width;
+    }
+    bool test(size_t i) const
+    {
+        return (words[i >> 6] >> (i & 63)) & 1;
+    }
+    void set(size_t i)
+    {
+        words[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    void reset(size_t i)
+    {
+        words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+    void clear()
+    {
+        std::fill(words.begin(), words.end(), 0);
+    }
+    // 置位并返回该位此前是否为0
+    bool insert(size_t i)
+    {
+        uint64_t mask = uint64_t(1) << (i & 63);
+        bool fresh = !(words[i >> 6] & mask);
+        words[i >> 6] |= mask;
+        return fresh;
+    }
+    // 并入另一个集合，返回本集合是否发生变化
+    bool merge(const Bitset &b)
+    {
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words.size(); i++)
+        {
+            uint64_t w = words[i] | b.words[i];
+            changed |= w ^ words[i];
+            words[i] = w;
+        }
+        return changed != 0;
+    }
+    Bitset &operator|=(const Bitset &b)
+    {
+        merge(b);
+        return *this;
+    }
+    Bitset &operator&=(const Bitset &b)
+    {
+        for (size_t i = 0; i < words.size(); i++)
+            words[i] &= b.words[i];
+        return *this;
+    }
+    bool operator==(const Bitset &b) const
+    {
+        return width == b.width && words == b.words;
+    }
+    bool operator!=(const Bitset &b) const
+    {
+        return !(*this == b);
+    }
+    bool any() const
+    {
+        for (auto w : words)
+            if (w)
+                return true;
+        return false;
+    }
+    bool intersects(const Bitset &b) const
+    {
+        for (size_t i = 0; i < words.size(); i++)
+            if (words[i] & b.words[i])
+                return true;
+        return false;
+    }
+    size_t count() const
+    {
+        size_t cnt = 0;
+        for (auto w : words)
+            cnt += std::popcount(w);
+        return cnt;
+    }
+    size_t hash() const
+    {
+        size_t h = width;
+        for (auto w : words)
+            h = h * 0x9E3779B97F4A7C15ull + (w ^ (w >> 29));
+        return h;
+    }
+    // 按从小到大的顺序遍历所有置位的下标
+    template <typename func_t>
+    void foreach (func_t f) const
+    {
+        for (size_t i = 0; i < words.size(); i++)
+        {
+            uint64_t w = words[i];
+            while (w)
+            {
+                f(i * 64 + std::countr_zero(w));
+                w &= w - 1;
+            }
+        }
+    }
+    const std::vector<uint64_t> &data() const
+    {
+        return words;
+    }
+};
+
+template <>
+struct std::hash<Bitset>
+{
+    size_t operator()(const Bitset &b) const
+    {
+        return b.hash();
+    }
+};
@@ -10,22 +10,143 @@
 
 #include "log.h"
 
-#include <sstream>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <algorithm>
 
-StrFormatter::StrFormatter(std::string s)
+using namespace std;
+
+// 参数不足时，剩余的占位符被忽略
+std::string StrFormatter::str()
 {
-    std::stringstream ss(s);
-    std::string seg;
-    while (std::getline(ss, seg, '$'))
-        segs.push(seg);
+    for (char c : rest)
+        if (c != '$')
+            ss << c;
+    rest = string_view();
+    return ss.str();
 }
 
-std::string StrFormatter::str()
+// 日志缓冲区，直接追加到字符串末尾，便于按行切分
+class LogBuffer : public streambuf
 {
-    while (!segs.empty())
+public:
+    string buf;
+
+protected:
+    int_type overflow(int_type c) override
     {
-        ss << segs.front();
-        segs.pop();
+        if (c != traits_type::eof())
+            buf.push_back(traits_type::to_char_type(c));
+        return c;
     }
-    return ss.str();
+    streamsize xsputn(const char *s, streamsize n) override
+    {
+        buf.append(s, n);
+        return n;
+    }
+};
+
+struct ThreadLog
+{
+    LogBuffer buffer;
+    ostream os{&buffer};
+};
+
+static thread_local ThreadLog threadLog;
+
+static void consoleSink(log_level_t, const char *, string_view text)
+{
+    cout.write(text.data(), text.size());
+}
+
+static atomic<log_sink_t> currentSink{consoleSink};
+
+void setLogSink(log_sink_t sink)
+{
+    currentSink.store(sink ? sink : consoleSink);
+}
+
+// 各模块的级别槽位只在设置级别和首次注册时加锁，日志语句读取槽位时不加锁
+struct LogRegistry
+{
+    mutex mtx;
+    int global = LOG_DEBUG;
+    vector<pair<string, int>> rules;             // 路径片段 -> 级别，后设置的优先
+    map<string, unique_ptr<atomic<int>>> slots; // 源文件路径 -> 级别槽位
+
+    int levelOf(const string &path) const
+    {
+        for (auto it = rules.rbegin(); it != rules.rend(); it++)
+            if (path.find(it->first) != string::npos)
+                return it->second;
+        return global;
+    }
+    void refresh()
+    {
+        for (auto &slot : slots)
+            slot.second->store(levelOf(slot.first), memory_order_relaxed);
+    }
+};
+
+static LogRegistry &registry()
+{
+    static LogRegistry r;
+    return r;
+}
+
+// 统一使用'/'作为路径分隔符
+static string normalize(string path)
+{
+    replace(path.begin(), path.end(), '\\', '/');
+    return path;
+}
+
+const atomic<int> &logSlot(const char *module)
+{
+    LogRegistry &r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    string path = normalize(module);
+    auto &slot = r.slots[path];
+    if (slot == nullptr)
+        slot = make_unique<atomic<int>>(r.levelOf(path));
+    return *slot;
+}
+
+void setLogLevel(log_level_t level)
+{
+    LogRegistry &r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    r.global = level;
+    r.refresh();
+}
+
+void setLogLevel(const string &module, log_level_t level)
+{
+    LogRegistry &r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    r.rules.emplace_back(normalize(module), level);
+    r.refresh();
+}
+
+LogLine::LogLine(log_level_t level, const char *module, const char *tag)
+    : level(level), module(module), os(threadLog.os)
+{
+    os << tag;
+}
+
+/**
+ * @brief 将缓冲区中的内容交给输出端
+ *
+ * @param all 为真时输出全部内容，否则只输出到最后一个换行为止
+ */
+void LogLine::emit(bool all)
+{
+    string &buf = threadLog.buffer.buf;
+    size_t n = all ? buf.size() : buf.rfind('\n') + 1;
+    if (n == 0)
+        return;
+    currentSink.load(memory_order_relaxed)(level, module, string_view(buf.data(), n));
+    buf.erase(0, n);
 }
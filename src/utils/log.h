@@ -8,29 +8,117 @@
  *
  */
 
+/**
+ * 分级日志
+ * 1、编译期过滤：级别低于LOG_LEVEL（可在编译选项中定义）的日志语句在编译期被丢弃，不生成任何代码；
+ *    debug(n)另受所在源文件的DEBUG_LEVEL约束，n大于DEBUG_LEVEL的调试语句同样被丢弃
+ * 2、惰性求值：日志语句被过滤时，<<右侧的表达式（包括format()）都不会被求值
+ * 3、分模块级别：以源文件路径为模块，运行时可用setLogLevel("common/gram", LOG_WARN)按路径片段设置级别，
+ *    每个日志语句只在首次执行时查找一次所属模块，此后只读取一个原子变量
+ * 4、线程安全：每个线程将日志写入自己的缓冲区，在换行处或语句结束时整段交给输出端，
+ *    分析日志的过程不加锁，不同线程的日志行不会交错
+ */
+
 #pragma once
 
 #include "str.h"
 
+#include <atomic>
+#include <string>
+#include <string_view>
+
 #define _red(x) "\033[31m" << x << "\033[0m"
 #define _blue(x) "\033[34m" << x << "\033[0m"
 #define _green(x) "\033[32m" << x << "\033[0m"
 #define _yellow(x) "\033[33m" << x << "\033[0m"
 
-#define info std::cout << _green("[info] ")
-#define warn std::cout << _yellow("[warn] ")
-#define error std::cout << _red("[error] ")
-#define fetal std::cout << _red("[fetal] ")
+enum log_level_t
+{
+	LOG_DEBUG,
+	LOG_INFO,
+	LOG_WARN,
+	LOG_ERROR,
+	LOG_FATAL,
+	LOG_OFF,
+};
+
+// 编译期的最低日志级别，低于该级别的日志语句不生成代码
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_DEBUG
+#endif
+
+/**
+ * @brief 日志输出端，接收一段完整的日志文本（以换行结尾，或语句结束时的未完成行）
+ * 默认输出端将文本整段写入std::cout
+ */
+using log_sink_t = void (*)(log_level_t level, const char *module, std::string_view text);
+
+void setLogSink(log_sink_t sink);
+// 设置全局的运行时日志级别
+void setLogLevel(log_level_t level);
+// 设置路径中包含module的源文件的运行时日志级别，优先于全局级别
+void setLogLevel(const std::string &module, log_level_t level);
+// 获取模块（源文件）的级别槽位，由日志语句在首次执行时调用
+const std::atomic<int> &logSlot(const char *module);
+
+/**
+ * @brief 一条日志语句
+ * 语句结束时析构，将缓冲区中剩余的内容交给输出端
+ */
+class LogLine
+{
+	log_level_t level;
+	const char *module;
+	std::ostream &os;
+
+	void emit(bool all);
+
+public:
+	LogLine(log_level_t level, const char *module, const char *tag);
+	~LogLine() { emit(true); }
+	template <typename T>
+	LogLine &operator<<(const T &t)
+	{
+		os << t;
+		emit(false);
+		return *this;
+	}
+	LogLine &operator<<(std::ostream &(*manip)(std::ostream &))
+	{
+		manip(os);
+		emit(false);
+		return *this;
+	}
+};
+
+// 每个日志语句持有一个静态的级别槽位引用，只在首次执行时查找
+#define _log_slot() ([]() -> const std::atomic<int> & { static const std::atomic<int> &slot = logSlot(__FILE__); return slot; }())
+
+// 展开为一条不含else的for语句，调用处外层的if不会与之产生else配对的歧义
+// 日志级别低于LOG_LEVEL时条件为常量false，整条语句在编译期被消除
+#define _log(level, tag)                                                        \
+	for (bool _log_on = (level) >= LOG_LEVEL &&                                 \
+	                    (level) >= _log_slot().load(std::memory_order_relaxed); \
+	     _log_on; _log_on = false)                                              \
+		LogLine(level, __FILE__, tag)
 
+#define info _log(LOG_INFO, "\033[32m[info] \033[0m")
+#define warn _log(LOG_WARN, "\033[33m[warn] \033[0m")
+#define error _log(LOG_ERROR, "\033[31m[error] \033[0m")
+#define fetal _log(LOG_FATAL, "\033[31m[fetal] \033[0m")
+
+// 各源文件可在包含本文件之后重新定义DEBUG_LEVEL，作为该文件的调试详细程度
 #define DEBUG_LEVEL -1
 
-#define debug(level)          \
-	if (level <= DEBUG_LEVEL) \
-	std::cout << _blue("   [" #level "] ")
+#define _debug(level, tag)                                                        \
+	for (bool _log_on = (level) <= DEBUG_LEVEL && LOG_DEBUG >= LOG_LEVEL &&       \
+	                    LOG_DEBUG >= _log_slot().load(std::memory_order_relaxed); \
+	     _log_on; _log_on = false)                                                \
+		LogLine(LOG_DEBUG, __FILE__, tag)
+
+#define debug(level) _debug(level, "\033[34m   [" #level "] \033[0m")
 
-#define debug_u(level)        \
-	if (level <= DEBUG_LEVEL) \
-	std::cout
+#define debug_u(level) _debug(level, "")
 
 #define assert(x, msg)                                    \
 	if (!(x))                                             \
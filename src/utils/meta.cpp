@@ -85,9 +85,9 @@ meta_content_t MetaParser::parseMetas(string text)
         metaName = metaNameSet.find(hintName) != metaNameSet.end() ? hintName : *metaNameSet.begin();
         if (metaMark.second.size() == 0)
         {
-            lastLoc.first = vTmp.getStr().find('\n', nextLoc.second);
+            lastLoc.first = vTmp.getView().find('\n', nextLoc.second);
             if (lastLoc.first == string::npos)
-                lastLoc.first = vTmp.getStr().length();
+                lastLoc.first = vTmp.size();
             lastLoc.second = lastLoc.first;
         }
         else
@@ -96,7 +96,7 @@ meta_content_t MetaParser::parseMetas(string text)
         }
         assert(lastLoc != word_npos, "MetaParser: Invalid meta mark.");
         meta_content_t metaContent = parseMetas(
-            vTmp.getStr().substr(nextLoc.second, lastLoc.first - nextLoc.second));
+            std::string(vTmp.getView().substr(nextLoc.second, lastLoc.first - nextLoc.second)));
         metas[metaName].push_back(trim(metaContent));
         vTmp.replace(nextLoc, lastLoc, metaName);
         lastLoc = nextLoc;
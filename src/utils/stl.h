@@ -13,10 +13,25 @@
 #define _find(x, y) (x.find(y) != x.end())
 
 #include <string>
+#include <vector>
 #include <sstream>
+#include <functional>
 
 std::string trim(const std::string &str, const std::string &whitespace = " \t\0");
 
+// 整数序列的哈希函数，用于以项目编号序列为键的哈希表
+template <typename T>
+struct vector_hash
+{
+    size_t operator()(const std::vector<T> &v) const
+    {
+        size_t h = v.size();
+        for (auto &x : v)
+            h ^= std::hash<T>()(x) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
 template <typename T>
 std::string container2str(const T &s, std::string sep = ", ", std::string lr = "{}")
 {
@@ -11,28 +11,31 @@
 #pragma once
 
 #include <string>
-#include <queue>
 #include <sstream>
+#include <string_view>
 #include <iostream>
 
+// 按'$'占位符依次填入参数，格式串不做预先切分，只在填入参数时向后查找下一个占位符
 class StrFormatter
 {
     std::stringstream ss;
-    std::queue<std::string> segs;
+    std::string_view rest; // 尚未输出的格式串，需在整个format表达式中保持有效
 
 public:
-    StrFormatter(std::string s);
+    StrFormatter(std::string_view s) : rest(s) {}
 
-    StrFormatter(const char *s) : StrFormatter(std::string(s)) {}
+    StrFormatter(const std::string &s) : rest(s) {}
+
+    StrFormatter(const char *s) : rest(s) {}
 
     template <typename T>
     StrFormatter &operator,(const T &t)
     {
-        if (segs.empty())
+        size_t pos = rest.find('$');
+        if (pos == std::string_view::npos)
             return *this;
-        ss << segs.front();
-        segs.pop();
-        ss << t;
+        ss << rest.substr(0, pos) << t;
+        rest.remove_prefix(pos + 1);
         return *this;
     }
 
@@ -13,20 +13,26 @@
 #include "viewer.h"
 #include "utils/log.h"
 
+#include <memory>
+#include <algorithm>
+
 using code_loc_t = std::pair<size_t, size_t>;
 
 class ContextViewer : public Viewer
 {
-	std::vector<size_t> lineNoVec;
+	// 各行行尾位置，同一源文本派生的视图之间共享，拷贝视图时不重复扫描
+	std::shared_ptr<const std::vector<size_t>> lineNoVec;
 	void initialize()
 	{
+		auto vec = std::make_shared<std::vector<size_t>>();
 		size_t pos = str.find('\n');
-		while (pos != std::string::npos)
+		while (pos != std::string_view::npos)
 		{
-			lineNoVec.push_back(pos);
+			vec->push_back(pos);
 			pos = str.find('\n', pos + 1);
 		}
-		lineNoVec.push_back(str.size());
+		vec->push_back(str.size());
+		lineNoVec = vec;
 	}
 
 public:
@@ -35,7 +41,7 @@ public:
 		Viewer::operator=(v);
 	}
 
-	ContextViewer(std::string str) : Viewer(str)
+	ContextViewer(std::string str) : Viewer(std::move(str))
 	{
 		initialize();
 	}
@@ -45,39 +51,44 @@ public:
 		initialize();
 	}
 
-	std::pair<size_t, size_t> getCurLineCol() const
+	// 获取源文本中任意位置的行列号，二分查找行表
+	code_loc_t locate(size_t offset) const
 	{
-		size_t ln = getLineNo();
-		size_t col = getPos() - (ln > 1 ? lineNoVec[ln - 2] + 1 : 0);
+		size_t ln = lineNoOf(offset);
+		size_t col = offset - (ln > 1 ? (*lineNoVec)[ln - 2] + 1 : 0);
 		return std::make_pair(ln, col);
 	}
 
+	std::pair<size_t, size_t> getCurLineCol() const
+	{
+		return locate(getPos());
+	}
+
 	std::string getLine(size_t lineNo = -1) const
 	{
 		if (lineNo == -1)
 			lineNo = getLineNo();
-		size_t start = lineNo > 1 ? lineNoVec[lineNo - 2] + 1 : 0;
-		size_t end = lineNoVec[lineNo - 1];
-		return str.substr(start, end - start);
+		size_t start = lineNo > 1 ? (*lineNoVec)[lineNo - 2] + 1 : 0;
+		size_t end = (*lineNoVec)[lineNo - 1];
+		return std::string(str.substr(start, end - start));
+	}
+
+	// 行号为严格位于offset之前的行尾数量加一
+	size_t lineNoOf(size_t offset) const
+	{
+		auto it = std::lower_bound(lineNoVec->begin(), lineNoVec->end(), offset);
+		return (it - lineNoVec->begin()) + 1;
 	}
 
 	size_t getLineNo() const
 	{
-		size_t lineNo = 1;
-		for (auto i : lineNoVec)
-		{
-			if (pos > i)
-				lineNo++;
-			else
-				break;
-		}
-		return lineNo;
+		return lineNoOf(pos);
 	}
 
 	code_loc_t getLnAndCol() const
 	{
 		size_t lineNo = getLineNo();
-		size_t start = lineNo > 1 ? lineNoVec[lineNo - 2] : 0;
+		size_t start = lineNo > 1 ? (*lineNoVec)[lineNo - 2] : 0;
 		return std::make_pair(lineNo, pos - start);
 	}
 
@@ -91,7 +102,7 @@ public:
 	void printContext(const size_t ln, const size_t col) const
 	{
 		size_t startLine = ln - 1 > 0 ? ln - 1 : 1;
-		size_t lineMax = lineNoVec.size();
+		size_t lineMax = lineNoVec->size();
 		size_t endLine = ln + 1 < lineMax ? ln + 1 : lineMax;
 		for (size_t i = startLine; i <= endLine; i++)
 		{
@@ -109,6 +120,6 @@ public:
 	void skipToNextLine()
 	{
 		size_t lineNo = getLineNo();
-		skip(lineNoVec[lineNo - 1] - getPos() + 1);
+		skip((*lineNoVec)[lineNo - 1] - getPos() + 1);
 	}
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * @file utils/mmap.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Read-only Memory Mapped File
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "mmap.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+shared_ptr<const void> mapFile(const string &filename, string_view &content)
+{
+    HANDLE file = CreateFileA(
+        filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+        return nullptr;
+    const void *addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (addr == NULL)
+        return nullptr;
+    content = string_view((const char *)addr, (size_t)size.QuadPart);
+    return shared_ptr<const void>(
+        addr, [](const void *p)
+        { UnmapViewOfFile(p); });
+}
+
+#else
+
+shared_ptr<const void> mapFile(const string &filename, string_view &content)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = st.st_size;
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return nullptr;
+    content = string_view((const char *)addr, size);
+    return shared_ptr<const void>(
+        addr, [size](const void *p)
+        { munmap(const_cast<void *>(p), size); });
+}
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file utils/mmap.h
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Read-only Memory Mapped File
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 以只读方式将文件映射到内存
+ * 返回的句柄负责维持映射的生命周期，句柄释放时自动解除映射
+ * 映射失败（如文件为空或平台不支持）时返回空句柄，调用者应退回到普通读取
+ *
+ * @param filename 文件路径
+ * @param content 映射成功时指向文件内容
+ * @return std::shared_ptr<const void> 映射句柄
+ */
+std::shared_ptr<const void> mapFile(const std::string &filename, std::string_view &content);
@@ -17,20 +17,17 @@
 
 class TokenViewer
 {
-    std::vector<token> &tokens;
+    std::vector<token> *tokens; // 仅引用外部的词法单元序列，拷贝视图不拷贝序列
     size_t index;
 
 public:
-    TokenViewer(std::vector<token> &tokens) : tokens(tokens), index(0) {}
-    void operator=(TokenViewer &v)
-    {
-        tokens = v.tokens;
-        index = v.index;
-    }
+    TokenViewer(std::vector<token> &tokens) : tokens(&tokens), index(0) {}
+    TokenViewer(const TokenViewer &v) = default;
+    TokenViewer &operator=(const TokenViewer &v) = default;
     token &operator[](size_t i) const
     {
-        assert(i >= 0 && i < tokens.size());
-        return tokens[i];
+        assert(i >= 0 && i < tokens->size());
+        return (*tokens)[i];
     }
     size_t pos() const
     {
@@ -38,11 +35,11 @@ public:
     }
     size_t size() const
     {
-        return tokens.size();
+        return tokens->size();
     }
     bool ends() const
     {
-        return index >= tokens.size();
+        return index >= tokens->size();
     }
     token &current() const
     {
@@ -55,15 +52,15 @@ public:
     std::vector<token> rest() const
     {
         std::vector<token> ret;
-        for (size_t i = index; i < tokens.size(); i++)
-            ret.push_back(tokens[i]);
+        for (size_t i = index; i < tokens->size(); i++)
+            ret.push_back((*tokens)[i]);
         return ret;
     }
     std::vector<std::string> restTypes() const
     {
         std::vector<std::string> ret;
-        for (size_t i = index; i < tokens.size(); i++)
-            ret.push_back(*(tokens[i].type));
+        for (size_t i = index; i < tokens->size(); i++)
+            ret.push_back(*((*tokens)[i].type));
         return ret;
     }
 };
@@ -11,49 +11,75 @@
 #pragma once
 
 #include "utils/log.h"
+#include "mmap.h"
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <iomanip>
 #include <fstream>
 #include <iostream>
+#include <string_view>
 
 /**
  * @brief lightweight string viewer
+ * 视图本身不拥有源文本，只持有一个共享的只读缓冲区（std::string或文件映射）
+ * 拷贝视图、移动游标都不会拷贝源文本，所有由同一视图派生的视图共享同一缓冲区
  */
 class Viewer
 {
 protected:
-	std::string str;
+	std::shared_ptr<const void> holder; // 维持缓冲区生命周期，非持有模式下为空
+	std::string_view str;
 	size_t pos = 0;
 
+	// 以新字符串替换当前内容（写时复制，不影响共享原缓冲区的其他视图）
+	void reset(std::string &&s)
+	{
+		auto buf = std::make_shared<const std::string>(std::move(s));
+		str = *buf;
+		holder = buf;
+	}
+
 public:
 	static Viewer fromFile(std::string filename)
 	{
+		Viewer v;
+		// 优先使用只读内存映射，失败时（如空文件）退回到普通读取
+		v.holder = mapFile(filename, v.str);
+		if (v.holder != nullptr)
+			return v;
 		std::ifstream ifs(filename);
 		assert(
 			ifs.is_open(),
 			format("Cannot open file: $.", filename));
 		std::string str((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-		return Viewer(str);
+		v.reset(std::move(str));
+		return v;
+	}
+	// 非持有模式，调用者需保证sv所指内容在视图使用期间有效
+	static Viewer borrow(std::string_view sv)
+	{
+		Viewer v;
+		v.str = sv;
+		return v;
 	}
 	Viewer() = default;
-	Viewer(const std::string &str) : str(str) {}
-	Viewer(const Viewer &v)
+	Viewer(const std::string &s)
 	{
-		str = v.str;
-		pos = v.pos;
+		reset(std::string(s));
 	}
-	void operator=(Viewer v)
+	Viewer(std::string &&s)
 	{
-		str = v.str;
-		pos = v.pos;
+		reset(std::move(s));
 	}
-	bool operator>(Viewer &v) const
+	Viewer(const Viewer &v) = default;
+	Viewer &operator=(const Viewer &v) = default;
+	bool operator>(const Viewer &v) const
 	{
 		return pos > v.pos;
 	}
-	bool operator>=(Viewer &v) const
+	bool operator>=(const Viewer &v) const
 	{
 		return pos >= v.pos;
 	}
@@ -66,6 +92,11 @@ public:
 		}
 		return str[i];
 	}
+	// 获取第i个字符，越界时返回'\0'
+	char at(size_t i) const
+	{
+		return (*this)[i];
+	}
 	// 获取字符串大小
 	size_t size() const
 	{
@@ -106,9 +137,19 @@ public:
 	{
 		return pos;
 	}
-	// 获取字符串
+	// 获取字符串（拷贝）
 	std::string getStr() const
+	{
+		return std::string(str);
+	}
+	// 获取字符串视图（不拷贝）
+	std::string_view getView() const
 	{
 		return str;
 	}
+	// 获取底层字符数据（不拷贝）
+	const char *data() const
+	{
+		return str.data();
+	}
 };
@@ -21,9 +21,9 @@ class WordViewer : public Viewer
 {
     bool isWord(word_loc_t loc) const
     {
-        if (loc.first > 0 && !isspace(str[loc.first - 1]))
+        if (loc.first > 0 && !isspace(at(loc.first - 1)))
             return false;
-        if (loc.second < str.length() && !isspace(str[loc.second]))
+        if (loc.second < str.size() && !isspace(at(loc.second)))
             return false;
         return true;
     }
@@ -34,29 +34,29 @@ public:
         Viewer::operator=(v);
     }
     WordViewer() = default;
-    WordViewer(std::string str) : Viewer(str) {}
+    WordViewer(std::string str) : Viewer(std::move(str)) {}
     WordViewer(Viewer &v) : Viewer(v) {}
 
     std::string operator[](word_loc_t loc) const
     {
         assert(loc != word_npos && loc != word_end, "Invalid word location!");
-        return str.substr(loc.first, loc.second - loc.first);
+        return std::string(str.substr(loc.first, loc.second - loc.first));
     }
 
     std::vector<word_loc_t> wordsOfRestLine() const
     {
         std::vector<word_loc_t> ret;
         size_t start = current().first;
-        size_t end = str.find('\n', pos);
+        size_t end = std::min(str.find('\n', pos), str.size());
         while (start < end)
         {
             word_loc_t loc = std::make_pair(start, start);
-            while (loc.second < end && !isspace(str[loc.second]))
+            while (loc.second < end && !isspace(at(loc.second)))
                 loc.second++;
             if (loc.second > loc.first)
                 ret.push_back(loc);
             start = loc.second;
-            while (start < end && isspace(str[start]))
+            while (start < end && isspace(at(start)))
                 start++;
         }
         return ret;
@@ -81,23 +81,23 @@ public:
     {
         // 返回loc指定的单词的位置
         size_t start = p == -1 ? pos : p;
-        if (isspace(str[start]))
+        if (isspace(at(start)))
         {
             // 如果当前位置是空白，向前找到下一个单词的开头
-            while (isspace(str[start]) && start < str.length())
+            while (isspace(at(start)) && start < str.size())
                 start++;
-            if (start == str.length())
+            if (start == str.size())
                 return word_end;
         }
         else
         {
             // 如果当前位置不是空白，向后找到当前单词的开头
-            while (start > 0 && !isspace(str[start - 1]))
+            while (start > 0 && !isspace(at(start - 1)))
                 start--;
         }
         // 向后找到当前单词的结尾
         size_t end = start;
-        while (end < str.length() && !isspace(str[end]))
+        while (end < str.size() && !isspace(at(end)))
             end++;
         return std::make_pair(start, end);
     }
@@ -105,12 +105,12 @@ public:
     word_loc_t advance()
     {
         // 如果当前位置不是空白，向前找到当前单词的结尾空白
-        while (pos < str.length() && !isspace(str[pos]))
+        while (pos < str.size() && !isspace(at(pos)))
             pos++;
         // 如果当前位置是空白，向前找到下一个单词的开头
-        while (isspace(str[pos]) && pos < str.length())
+        while (isspace(at(pos)) && pos < str.size())
             pos++;
-        if (pos == str.length())
+        if (pos == str.size())
             return word_end;
         return current();
     }
@@ -118,16 +118,16 @@ public:
     word_loc_t advance(word_loc_t loc) const
     {
         // 如果当前位置不是空白，向前找到当前单词的结尾空白
-        while (loc.first < str.length() && !isspace(str[loc.first]))
+        while (loc.first < str.size() && !isspace(at(loc.first)))
             loc.first++;
         // 如果当前位置是空白，向前找到下一个单词的开头
-        while (isspace(str[loc.first]) && loc.first < str.length())
+        while (isspace(at(loc.first)) && loc.first < str.size())
             loc.first++;
-        if (loc.first == str.length())
+        if (loc.first == str.size())
             return word_end;
         loc.second = loc.first;
         // 向后找到下一个单词的结尾
-        while (loc.second < str.length() && !isspace(str[loc.second]))
+        while (loc.second < str.size() && !isspace(at(loc.second)))
             loc.second++;
         return loc;
     }
@@ -135,13 +135,13 @@ public:
     word_loc_t retreat()
     {
         // 如果当前位置不是空白，向后找到当前单词的前导空白
-        while (pos > 0 && !isspace(str[pos]))
+        while (pos > 0 && !isspace(at(pos)))
             pos--;
         // 如果当前位置是空白，向后找到上一个单词的结尾
-        while (isspace(str[pos]) && pos > 0)
+        while (isspace(at(pos)) && pos > 0)
             pos--;
         // 如果当前位置不是空白，向后找到当前单词的开头
-        while (pos > 0 && !isspace(str[pos - 1]))
+        while (pos > 0 && !isspace(at(pos - 1)))
             pos--;
         return current();
     }
@@ -149,15 +149,15 @@ public:
     word_loc_t retreat(word_loc_t loc) const
     {
         // 如果当前位置不是空白，向后找到当前单词的前导空白
-        while (loc.first > 0 && !isspace(str[loc.first]))
+        while (loc.first > 0 && !isspace(at(loc.first)))
             loc.first--;
         // 如果当前位置是空白，向后找到上一个单词的结尾
-        while (isspace(str[loc.first]) && loc.first > 0)
+        while (isspace(at(loc.first)) && loc.first > 0)
             loc.first--;
         // 记录下上一个单词的结尾
         loc.second = loc.first + 1;
         // 如果当前位置不是空白，向后找到当前单词的开头
-        while (loc.first > 0 && !isspace(str[loc.first - 1]))
+        while (loc.first > 0 && !isspace(at(loc.first - 1)))
             loc.first--;
         return loc;
     }
@@ -165,17 +165,16 @@ public:
     std::string swallow()
     {
         // 删掉当前单词
-        word_loc_t loc = current();
-        std::string ret = str.substr(loc.first, loc.second - loc.first);
-        str.erase(loc.first, loc.second - loc.first);
-        return ret;
+        return swallow(current());
     }
 
     std::string swallow(word_loc_t loc)
     {
         // 删掉loc指定的单词
-        std::string ret = str.substr(loc.first, loc.second - loc.first);
-        str.erase(loc.first, loc.second - loc.first);
+        std::string ret(str.substr(loc.first, loc.second - loc.first));
+        std::string buf(str);
+        buf.erase(loc.first, loc.second - loc.first);
+        reset(std::move(buf));
         return ret;
     }
 
@@ -188,14 +187,18 @@ public:
             [](const word_loc_t &a, const word_loc_t &b) -> bool
             { return a.first < b.first; });
         // 从后向前删掉locs指定的单词
+        std::string buf(str);
         for (auto rit = locs_.rbegin(); rit != locs_.rend(); rit++)
-            str.erase(rit->first, rit->second - rit->first);
+            buf.erase(rit->first, rit->second - rit->first);
+        reset(std::move(buf));
     }
 
     WordViewer &replace(word_loc_t l1, word_loc_t l2, std::string word)
     {
         // 用word替换l1到l2的单词
-        str.replace(l1.first, l2.second - l1.first, word);
+        std::string buf(str);
+        buf.replace(l1.first, l2.second - l1.first, word);
+        reset(std::move(buf));
         // 更新pos
         if (pos > l1.first)
         {
@@ -210,7 +213,7 @@ public:
     bool terminate() const
     {
         // 判断是否已经到达末尾
-        return pos >= str.length();
+        return pos >= str.size();
     }
 
     WordViewer &jumpToLoc(word_loc_t loc)
@@ -0,0 +1,66 @@
+/**
+ * @file compiled_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test Precompiled Grammar Artifact
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "lexer/lexer.h"
+#include "parser/syntax.h"
+#include "parser/compiled.h"
+#include "parser/eslr/parser.h"
+#include "utils/log.h"
+
+#include <chrono>
+#include <cstdio>
+
+void compiledTest()
+{
+    using namespace std::chrono;
+    const std::string syntaxLex = "./assets/lex/syntax.lex";
+    const std::string grammarFile = "./assets/stx/rsc-1.estx";
+    const std::string codeLex = "./assets/lex/rsc.lex";
+    const std::string cacheFile = "./rsc-1.gram";
+    std::remove(cacheFile.c_str());
+
+    // 首次构造并写入预编译文件
+    auto t0 = steady_clock::now();
+    CompiledGrammar::build(syntaxLex, grammarFile, codeLex, cacheFile);
+    auto t1 = steady_clock::now();
+    // 再次加载时直接映射预编译文件
+    CompiledGrammar cg = CompiledGrammar::build(syntaxLex, grammarFile, codeLex, cacheFile);
+    Grammar g = cg.getGrammar();
+    PackedLRTable table = cg.getTable();
+    Lexer lexer = cg.getLexer();
+    auto t2 = steady_clock::now();
+
+    uint64_t key = CompiledGrammar::hashFiles({syntaxLex, grammarFile, codeLex});
+    CompiledGrammar stale;
+    assert(!stale.load(cacheFile, key + 1), "Compiled grammar test: stale artifact accepted.");
+
+    Viewer code = Viewer::fromFile("./assets/src/test.rsc");
+    TokenStream stream = lexer.scan(code);
+    g.transferTokens(stream);
+    ESLR1Parser loaded(g, table);
+    bool r1 = loaded.parse(stream, code);
+
+    // 由源文件构造的版本
+    SyntaxParser syntax(syntaxLex);
+    SLR1Grammar G = SLR1Grammar(syntax.parse(grammarFile));
+    Lexer fresh(codeLex);
+    TokenStream freshStream = fresh.scan(code);
+    G.transferTokens(freshStream);
+    ESLR1Parser parser(G);
+    bool r2 = parser.parse(freshStream, code);
+
+    assert(r1 && r2, "Compiled grammar test: parsing failed.");
+    assert(sameTree(parser.getCST(), loaded.getCST()), "Compiled grammar test: CST differs.");
+    info << "Build: " << duration_cast<microseconds>(t1 - t0).count() << " us, "
+         << "load: " << duration_cast<microseconds>(t2 - t1).count() << " us." << endl;
+    std::remove(cacheFile.c_str());
+    info << "Compiled grammar test passed." << endl;
+}
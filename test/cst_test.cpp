@@ -48,4 +48,50 @@ void cstTest()
     *ndBody << pst_node_t::createNode(TERMINAL, "}", 0, 0);
     ndBody->print();
     cst->print();
+
+    // 三种非递归遍历的顺序
+    auto dumpOrder = [](auto walker)
+    {
+        std::string s;
+        for (auto &node : walker)
+            if (node.data.type == TERMINAL)
+                s += node.data.symbol + " ";
+        return s;
+    };
+    info << "Preorder terminals: " << dumpOrder(walkPreorder(*cst)) << std::endl;
+    info << "Postorder terminals: " << dumpOrder(walkPostorder(*cst)) << std::endl;
+    info << "Levelorder terminals: " << dumpOrder(walkLevelorder(*cst)) << std::endl;
+
+    // 极深的树（如长列表右递归展开得到的树）不会耗尽调用栈
+    const size_t depth = 1000000;
+    pst_tree_ptr_t deep = pst_node_t::createNode(NON_TERM, "List", 0, 0);
+    pst_node_ptr_t cur = deep;
+    for (size_t i = 0; i < depth; i++)
+    {
+        pst_node_ptr_t next = pst_node_t::createNode(NON_TERM, "List", 0, 0);
+        *cur << pst_node_t::createNode(TERMINAL, "x", 0, 0) << next;
+        cur = next;
+    }
+    size_t pre = 0, post = 0, level = 0, maxDepth = 0;
+    auto range = walkPreorder(*deep);
+    for (auto it = range.begin(); it != range.end(); ++it)
+    {
+        pre++;
+        maxDepth = std::max(maxDepth, it.depth());
+    }
+    deep->postorder([&](const pst_node_t &)
+                    { post++; });
+    for ([[maybe_unused]] auto &node : walkLevelorder(*deep))
+        level++;
+    info << format("Deep tree: $ nodes, depth $, preorder $, postorder $, levelorder $",
+                   depth * 2 + 1, maxDepth, pre, post, level)
+         << std::endl;
+    // shared_ptr的析构同样是递归的，逐层拆开后再释放
+    cur = deep;
+    while (cur->hasChild())
+    {
+        pst_node_ptr_t next = cur->lastChild();
+        cur->clear();
+        cur = next;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+/**
+ * @file dfa_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test DFA
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "lexer/dfa.h"
+#include "lexer/lazy_dfa.h"
+#include "lexer/lexer.h"
+#include "lexer/regexp/parser.h"
+#include "utils/log.h"
+
+void dfaTest()
+{
+    vector<string> regexps = {
+        "\\s+",
+        "//[^\\r\\n]*",
+        "/\\*([^\\*]|\\*[^/])*\\*/",
+        "[\\a_][\\w]*",
+        "\"[^\"]*\"",
+        "(\\-|\\+|\\e)[\\d]+\\.[\\d]+(\\e|e(\\-|\\+|\\e)[\\d]+)",
+        "(\\-|\\+|\\e)0[xX]([\\da-fA-F]+|[\\d]+)(e(\\-|\\+|\\e)[\\d]+)?",
+        ">=|<=|!=|==|\\|\\||&&",
+    };
+    Viewer code = Viewer::fromFile("./assets/src/test.rsc");
+    for (auto &reg : regexps)
+    {
+        RegexpParser parser(reg);
+        FiniteAutomaton nfa = parser.parse();
+        DFA dfa(nfa);
+        LazyDFA lazyDfa(nfa, 4); // 缓存很小，迫使匹配中清空缓存并改用NFA模拟
+        size_t edges = 0;
+        for (auto &trans : nfa.getTransitions())
+            edges += trans.eps.size() + trans.edges.size();
+        info << "DFA of " << reg << ": " << dfa.size() << " states, " << dfa.getClassCount() << " byte classes, "
+             << dfa.acceleratedStates() << " accelerated "
+             << "(NFA: " << nfa.getStates().size() << " states, " << edges << " transitions)" << endl;
+        dfa.printStates();
+        // 在源文件的每个位置上比较NFA与DFA的最长匹配长度
+        size_t mismatch = 0;
+        for (size_t i = 0; i < code.size(); i++)
+        {
+            Viewer vNfa = code;
+            vNfa.jump(i);
+            string result;
+            size_t nfaLen = 0;
+            if (nfa.accepts(vNfa, result))
+            {
+                while (!result.empty() && result.back() == 0)
+                    result.pop_back();
+                nfaLen = result.size();
+            }
+            Viewer vDfa = code;
+            vDfa.jump(i);
+            size_t dfaLen = dfa.match(vDfa);
+            size_t lazyLen = lazyDfa.match(vDfa);
+            if (nfaLen != dfaLen || nfaLen != lazyLen)
+            {
+                error << "Mismatch at " << i << ": NFA " << nfaLen << ", DFA " << dfaLen << ", LazyDFA " << lazyLen << endl;
+                mismatch++;
+            }
+        }
+        assert(mismatch == 0, format("DFA mismatches NFA on $ positions.", mismatch));
+        auto &stats = lazyDfa.getStats();
+        info << "LazyDFA of " << reg << ": " << stats.misses << " misses, " << stats.flushes << " flushes, "
+             << stats.fallbacks << " fallbacks" << endl;
+    }
+    // 比较逐类型匹配与合并自动机匹配得到的词法单元序列
+    vector<pair<string, string>> cases = {
+        {"./assets/lex/cpp.lex", "./assets/src/code.cpp"},
+        {"./assets/lex/rsc.lex", "./assets/src/test.rsc"},
+        {"./assets/lex/psl.lex", "./assets/src/roft.psl"},
+    };
+    for (auto &c : cases)
+    {
+        Lexer lexer(c.first);
+        Viewer src = Viewer::fromFile(c.second);
+        auto expected = lexer.tokenize(src);
+        auto check = [&](const vector<token> &actual, const string &mode)
+        {
+            assert(expected.size() == actual.size(), format("Token count mismatch on $ ($).", c.second, mode));
+            for (size_t i = 0; i < expected.size(); i++)
+            {
+                bool same = expected[i].type == actual[i].type &&
+                            expected[i].value == actual[i].value &&
+                            expected[i].line == actual[i].line &&
+                            expected[i].col == actual[i].col;
+                assert(same, format("Token $ mismatch on $ ($).", i, c.second, mode));
+            }
+            info << c.second << ": " << actual.size() << " tokens match (" << mode << ")." << endl;
+        };
+        lexer.useCombinedAutomaton();
+        check(lexer.tokenize(src), "combined");
+        info << c.second << ": " << lexer.getCombinedAutomaton().acceleratedStates() << " of "
+             << lexer.getCombinedAutomaton().size() << " states accelerated." << endl;
+        lexer.useLazyAutomaton();
+        check(lexer.tokenize(src), "lazy");
+        lexer.useLazyAutomaton(true, 8);
+        check(lexer.tokenize(src), "lazy, 8 states");
+        auto &stats = lexer.getLazyAutomaton().getStats();
+        info << c.second << ": " << stats.misses << " misses, " << stats.flushes << " flushes, "
+             << stats.fallbacks << " fallbacks with 8 cached states" << endl;
+    }
+    // 自环加速：与逐字节判断比较，覆盖各种长度和停止位置
+    vector<CharSet> sets = {
+        ~CharSet(set<char>{'\r', '\n'}), ~CharSet::of('*'), ~CharSet(), CharSet(set<char>{' ', '\t', '\n', '\v', '\f', '\r'}),
+        CharSet::range('0', '9') |= CharSet::range('a', 'z') |= CharSet::range('A', 'Z') |= CharSet::of('_'),
+        CharSet::range(0x80, 0xff), CharSet::of('x')};
+    string bytes(Viewer::fromFile("./assets/src/code.cpp").getView());
+    for (int c = 0; c < 256; c++)
+        bytes += string(c % 7 + 1, (char)c);
+    for (auto &charset : sets)
+    {
+        skip_kernel_t kernel = skip_kernel_t::of(charset);
+        assert(kernel.kind != SKIP_NONE, format("Set $ is not accelerated.", charset.desc()));
+        for (size_t i = 0; i < bytes.size(); i++)
+        {
+            const char *begin = bytes.data() + i, *end = bytes.data() + min(bytes.size(), i + 1 + i % 71);
+            const char *expected = begin;
+            while (expected != end && charset.contains(*expected))
+                expected++;
+            assert(kernel.skip(begin, end) == expected, format("Skipping $ mismatches at $.", charset.desc(), i));
+        }
+    }
+    assert(skip_kernel_t::of(CharSet(set<char>{'a', 'c', 'e', 'g', 'i'})).kind == SKIP_NONE, "Scattered set should not be accelerated.");
+    info << "Skip kernels match byte-by-byte scanning." << endl;
+    info << "DFA test passed." << endl;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file incr_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test Incremental Grammar Update
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "parser/syntax.h"
+#include "common/gram/slr1.h"
+#include "utils/log.h"
+
+#include <chrono>
+
+// 以与构造时相同的顺序（广度优先，先非终结符后终结符）重新编号，返回各状态的分析表行
+static vector<string> canonicalRows(const SLR1Grammar &G)
+{
+    vector<symbol_t> symbols(G.nonTerms.begin(), G.nonTerms.end());
+    symbols.insert(symbols.end(), G.terminals.begin(), G.terminals.end());
+    vector<size_t> canon(G.clusters.size(), SIZE_MAX), order = {0};
+    canon[0] = 0;
+    for (size_t i = 0; i < order.size(); i++)
+        for (auto &sym : symbols)
+        {
+            auto it = G.goTrans.find(mkcrd((state_id_t)order[i], sym));
+            if (it != G.goTrans.end() && canon[it->second] == SIZE_MAX)
+            {
+                canon[it->second] = order.size();
+                order.push_back(it->second);
+            }
+        }
+    vector<string> rows;
+    for (auto s : order)
+    {
+        string row = cluster2str(G.clusters[s]) + " |";
+        for (auto &sym : symbols)
+        {
+            auto it = G.slr1Table.find(mkcrd((state_id_t)s, sym));
+            if (it == G.slr1Table.end())
+                continue;
+            const action_t &act = it->second;
+            row += " " + sym + ":";
+            if (act.index() == 0)
+                row += "ACC";
+            else if (act.index() == 1)
+                row += product2str(get<1>(act));
+            else
+                row += "S" + to_string(canon[get<2>(act)]);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+void incrTest()
+{
+    using namespace std::chrono;
+    SyntaxParser syntax("./assets/lex/syntax.lex");
+    Grammar g = syntax.parse("./assets/stx/rsc-1.estx");
+    SLR1Grammar G(g);
+
+    // 删除一个产生式
+    Grammar g1 = g;
+    product_t removed = make_pair(symbol_t("VarType"), symstr_t{"char"});
+    g1.products.erase(find(g1.products.begin(), g1.products.end(), removed));
+    g1.rules[removed.first].erase(removed.second);
+    auto t0 = steady_clock::now();
+    size_t refilled = G.update(g1);
+    auto t1 = steady_clock::now();
+    SLR1Grammar F1(g1);
+    auto t2 = steady_clock::now();
+    assert(canonicalRows(G) == canonicalRows(F1), "Incremental test: update (remove) differs from full build.");
+    info << "Remove: " << refilled << " of " << G.clusters.size() << " states refilled, update "
+         << duration_cast<microseconds>(t1 - t0).count() << " us, full build "
+         << duration_cast<microseconds>(t2 - t1).count() << " us." << endl;
+
+    // 再加回该产生式
+    refilled = G.update(g);
+    SLR1Grammar F0(g);
+    assert(canonicalRows(G) == canonicalRows(F0), "Incremental test: update (add) differs from full build.");
+    info << "Add: " << refilled << " of " << G.clusters.size() << " states refilled." << endl;
+
+    // 增加一个产生式，使其他状态中规约项目的Follow集变化：B ::= A y 使Follow(A)增加y，
+    // 而状态{A -> c., A -> c.x}中A -> c的规约原本只在x上，且被x上的移进覆盖，不出现在分析表中
+    SyntaxParser small("./assets/lex/syntax.lex");
+    Grammar h = small.parse("./assets/stx/incr.stx");
+    SLR1Grammar H(h);
+    Grammar h1 = h;
+    product_t added = make_pair(symbol_t("B"), symstr_t{"A", "y"});
+    h1.products.push_back(added);
+    h1.rules[added.first].insert(added.second);
+    refilled = H.update(h1);
+    SLR1Grammar FH(h1);
+    assert(canonicalRows(H) == canonicalRows(FH), "Incremental test: update (follow change) differs from full build.");
+    info << "Follow change: " << refilled << " of " << H.clusters.size() << " states refilled." << endl;
+    info << "Incremental grammar test passed." << endl;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file intg_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test Integer-keyed Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "parser/syntax.h"
+#include "common/gram/slr1.h"
+#include "common/gram/int/slr1.h"
+#include "utils/log.h"
+
+static size_t compareGrammar(const SLR1Grammar &G, const IntSLR1Grammar &I)
+{
+    size_t diff = 0;
+    // Follow集
+    for (auto &v : G.nonTerms)
+    {
+        symset_t s;
+        I.follow[I.ntIndex(I.symtab.id(v))].foreach ([&](size_t t)
+                                                     { s.insert(I.name(t)); });
+        if (s != G.follow.at(v))
+        {
+            warn << "Follow(" << v << ") differs: " << set2str(G.follow.at(v)) << " vs " << set2str(s) << endl;
+            diff++;
+        }
+    }
+    // 项目集
+    if (G.clusters.size() != I.clusters.size())
+    {
+        warn << "Cluster count differs: " << G.clusters.size() << " vs " << I.clusters.size() << endl;
+        return diff + 1;
+    }
+    for (size_t i = 0; i < G.clusters.size(); i++)
+    {
+        set<string> s1, s2;
+        for (auto &item : G.clusters[i])
+            s1.insert(item2str(item));
+        for (auto item : I.clusters[i])
+            s2.insert(I.item2str(item));
+        if (s1 != s2)
+        {
+            warn << "Cluster " << i << " differs." << endl;
+            diff++;
+        }
+    }
+    // 分析表
+    if (G.slr1Table.size() != I.slr1Table.size())
+    {
+        warn << "Table size differs: " << G.slr1Table.size() << " vs " << I.slr1Table.size() << endl;
+        diff++;
+    }
+    for (auto &entry : G.slr1Table)
+    {
+        int_action_t act = I.action(entry.first.first, I.symtab.id(entry.first.second));
+        const action_t &ref = entry.second;
+        bool same = false;
+        if (ref.index() == 0)
+            same = act.kind == ACT_ACCEPT;
+        else if (ref.index() == 1)
+            same = act.kind == ACT_REDUCE && I.product2str(act.value) == product2str(get<1>(ref));
+        else
+            same = act.kind == ACT_SHIFT && act.value == get<2>(ref);
+        if (!same)
+        {
+            warn << "Table entry (" << entry.first.first << ", " << entry.first.second << ") differs." << endl;
+            diff++;
+        }
+    }
+    return diff;
+}
+
+void intGramTest()
+{
+    vector<string> grammars = {
+        "./assets/stx/rsc-1.estx",
+        "./assets/stx/psl.stx",
+    };
+    size_t diff = 0;
+    for (auto &path : grammars)
+    {
+        SyntaxParser syntax("./assets/lex/syntax.lex");
+        Grammar g = syntax.parse(path);
+        SLR1Grammar G(g);
+        IntSLR1Grammar I(g);
+        info << path << ": " << I.symtab.terminalCount() << " terminals, "
+             << I.symtab.nonTermCount() << " non-terminals, "
+             << I.clusters.size() << " states." << endl;
+        diff += compareGrammar(G, I);
+        // 多线程构造的项目集规范族与单线程构造完全一致
+        SLR1Grammar P(g, 4);
+        if (P.clusters.size() != G.clusters.size() || P.goTrans != G.goTrans)
+        {
+            warn << "Parallel construction differs." << endl;
+            diff++;
+        }
+        for (size_t i = 0; i < P.clusters.size() && i < G.clusters.size(); i++)
+        {
+            if (cluster2str(P.clusters[i]) != cluster2str(G.clusters[i]))
+            {
+                warn << "Parallel cluster " << i << " differs." << endl;
+                diff++;
+            }
+        }
+    }
+    if (diff == 0)
+        info << "Integer grammar test passed." << endl;
+    else
+        error << "Integer grammar test failed with " << diff << " differences." << endl;
+}
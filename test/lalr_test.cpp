@@ -0,0 +1,48 @@
+/**
+ * @file lalr_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test LALR(1) Grammar
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "lexer/lexer.h"
+#include "parser/syntax.h"
+#include "parser/eslr/parser.h"
+#include "common/gram/lalr1.h"
+#include "utils/log.h"
+
+void lalr1Test()
+{
+    SyntaxParser syntax("./assets/lex/syntax.lex");
+
+    // 经典的非SLR(1)但属于LALR(1)的文法：S -> L = R | R, L -> * R | id, R -> L
+    Grammar g = syntax.parse("./assets/stx/lalr.stx");
+    SLR1Grammar S = SLR1Grammar(g);
+    LALR1Grammar L = LALR1Grammar(g);
+    assert(!S.checkSLR1(), "LALR(1) test: expected SLR(1) conflicts.");
+    assert(L.checkLALR1(), "LALR(1) test: unexpected LALR(1) conflicts.");
+    for (state_id_t s = 0; s < L.clusters.size(); s++)
+        for (auto &item : L.clusters[s])
+            if (item.second == item.first.get().second.size() && item.first.get().first == "R")
+                info << "LA(" << s << ", R->L) = " << set2str(L.lookaheadOf(s, &item.first.get() - &L.products[0])) << endl;
+
+    // LALR(1)分析表与SLR(1)分析表得到相同的语法树
+    Grammar rsc = syntax.parse("./assets/stx/rsc-1.estx");
+    SLR1Grammar G = SLR1Grammar(rsc);
+    LALR1Grammar LG = LALR1Grammar(rsc);
+    bool slrOk = G.checkSLR1(), lalrOk = LG.checkLALR1();
+    info << "rsc-1: SLR(1) " << (slrOk ? "ok" : "has conflicts") << ", LALR(1) "
+         << (lalrOk ? "ok" : "has conflicts") << "." << endl;
+    Lexer lexer("./assets/lex/rsc.lex");
+    Viewer code = Viewer::fromFile("./assets/src/test.rsc");
+    TokenStream stream = lexer.scan(code);
+    G.transferTokens(stream);
+    ESLR1Parser slr(G), lalr(LG);
+    assert(slr.parse(stream, code) && lalr.parse(stream, code), "LALR(1) test: parsing failed.");
+    assert(sameTree(slr.getCST(), lalr.getCST()), "LALR(1) test: CST differs.");
+    info << "LALR(1) test passed." << endl;
+}
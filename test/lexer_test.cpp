@@ -10,6 +10,31 @@
 
 #include "test.h"
 #include "lexer/lexer.h"
+#include "utils/log.h"
+
+#include <chrono>
+
+static vector<string> lexErrors;
+
+static void errorSink(log_level_t level, const char *module, std::string_view text)
+{
+    if (level == LOG_ERROR)
+        lexErrors.emplace_back(text);
+}
+
+// 扫描big并收集报告的错误，期间关闭其他输出
+static TokenStream scanQuietly(const Lexer &lexer, const Viewer &big, size_t threads, vector<string> &errors)
+{
+    lexErrors.clear();
+    setLogSink(errorSink);
+    streambuf *buf = cout.rdbuf(nullptr);
+    TokenStream tokens = threads ? lexer.scanParallel(big, threads) : lexer.scan(big);
+    cout.rdbuf(buf);
+    cout.clear();
+    setLogSink(nullptr);
+    errors.swap(lexErrors);
+    return tokens;
+}
 
 void lexerTest()
 {
@@ -18,4 +43,47 @@ void lexerTest()
     Viewer codeViewer = Viewer::fromFile("./assets/src/error.cpp");
     auto tokens = lexer.tokenize(codeViewer);
     Lexer::printTokens(tokens);
+
+    // 并行扫描：分块的接缝会落在跨行的块注释、字符串以及无法匹配的行中，结果须与顺序扫描完全一致
+    using namespace std::chrono;
+    string unit(Viewer::fromFile("./assets/src/code.cpp").getView());
+    string bad(codeViewer.getView());
+    string big;
+    for (size_t i = 0; big.size() < (3 << 20); i++)
+    {
+        big += unit;
+        big += "/*\n";
+        for (size_t j = 0; j < 100 + i % 37; j++)
+            big += " * \"comment\" line\n";
+        big += "*/\nconst char *s = \"\n";
+        for (size_t j = 0; j < 50 + i % 23; j++)
+            big += "string /* line\n";
+        big += "\";\n";
+        if (i % 16 == 0)
+            big += bad;
+    }
+    lexer.useCombinedAutomaton();
+    Viewer bigView(big);
+    vector<string> expectedErrors, actualErrors;
+    auto t0 = steady_clock::now();
+    TokenStream expected = scanQuietly(lexer, bigView, 0, expectedErrors);
+    auto t1 = steady_clock::now();
+    for (size_t threads : {2, 3, 8})
+    {
+        auto t2 = steady_clock::now();
+        TokenStream actual = scanQuietly(lexer, bigView, threads, actualErrors);
+        auto t3 = steady_clock::now();
+        assert(actual.size() == expected.size(), format("Parallel scan ($ threads) token count mismatch.", threads));
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            bool same = actual[i].type == expected[i].type && actual[i].offset == expected[i].offset &&
+                        actual[i].length == expected[i].length && actual.lineCol(i) == expected.lineCol(i);
+            assert(same, format("Parallel scan ($ threads) mismatch at token $.", threads, i));
+        }
+        assert(actualErrors == expectedErrors, format("Parallel scan ($ threads) reports different errors.", threads));
+        info << "Parallel scan with " << threads << " threads: " << duration_cast<milliseconds>(t3 - t2).count()
+             << " ms, sequential: " << duration_cast<milliseconds>(t1 - t0).count() << " ms" << endl;
+    }
+    info << big.size() << " bytes, " << expected.size() << " tokens, " << expectedErrors.size()
+         << " errors match in parallel scan." << endl;
 }
\ No newline at end of file
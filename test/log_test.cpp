@@ -12,8 +12,56 @@
 #include "utils/table.h"
 #include "test.h"
 
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::mutex capturedLock;
+static std::vector<std::string> captured;
+
+static void captureSink(log_level_t level, const char *module, std::string_view text)
+{
+    std::lock_guard<std::mutex> lock(capturedLock);
+    captured.emplace_back(text);
+}
+
 void logTest()
 {
+    // 被过滤的日志语句不对参数求值
+    int evaluated = 0;
+    auto touch = [&]()
+    {
+        evaluated++;
+        return "touched";
+    };
+    setLogLevel(LOG_WARN);
+    info << touch() << std::endl;
+    setLogLevel(LOG_DEBUG);
+    assert(evaluated == 0, "Log test: filtered statement evaluated.");
+
+    // 分模块级别与多线程输出，每段输出都应是完整的一行
+    setLogSink(captureSink);
+    setLogLevel("test/log_test", LOG_ERROR);
+    warn << "hidden" << std::endl;
+    setLogLevel("test/log_test", LOG_DEBUG);
+    assert(captured.empty(), "Log test: module level ignored.");
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++)
+        workers.emplace_back(
+            [t]()
+            {
+                for (int i = 0; i < 1000; i++)
+                    info << "thread " << t << " line " << i << std::endl;
+            });
+    for (auto &w : workers)
+        w.join();
+    setLogSink(nullptr);
+    assert(captured.size() == 4000, format("Log test: $ lines captured.", captured.size()));
+    for (auto &line : captured)
+        assert(line.find("thread ") != std::string::npos && line.find('\n') == line.size() - 1,
+               format("Log test: broken line $.", line));
+    info << "Log test passed." << std::endl;
+
     // info << "info" << std::endl;
     // warn << "warn" << std::endl;
     // error << "error" << std::endl;
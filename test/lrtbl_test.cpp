@@ -0,0 +1,123 @@
+/**
+ * @file lrtbl_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test Packed LR Table
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "lexer/lexer.h"
+#include "parser/syntax.h"
+#include "parser/eslr/parser.h"
+#include "parser/slr1/parser.h"
+#include "utils/log.h"
+
+#include <chrono>
+
+void lrTableTest()
+{
+    using namespace std::chrono;
+    SyntaxParser syntax("./assets/lex/syntax.lex");
+    Grammar g = syntax.parse("./assets/stx/rsc-1.estx");
+    SLR1Grammar G = SLR1Grammar(g);
+    Lexer lexer("./assets/lex/rsc.lex");
+    lexer.useCombinedAutomaton();
+    Viewer code = Viewer::fromFile("./assets/src/test.rsc");
+
+    // 原有的逐步打印分析过程的版本
+    auto tokens = G.transferTokens(lexer.tokenize(code));
+    ESLR1Parser legacy(G);
+    auto t0 = steady_clock::now();
+    bool r1 = legacy.parse(tokens, code);
+    auto t1 = steady_clock::now();
+
+    // 同一版本关闭分析过程跟踪
+    tokens = G.transferTokens(lexer.tokenize(code));
+    ESLR1Parser quiet(G, TRACE_OFF);
+    auto q0 = steady_clock::now();
+    bool r0 = quiet.parse(tokens, code);
+    auto q1 = steady_clock::now();
+
+    // 基于紧凑分析表的版本
+    TokenStream stream = lexer.scan(code);
+    G.transferTokens(stream);
+    ESLR1Parser packed(G);
+    packed.parse(stream, code); // 首次分析时生成紧凑分析表
+    auto t2 = steady_clock::now();
+    bool r2 = packed.parse(stream, code);
+    auto t3 = steady_clock::now();
+
+    // 基于行位移压缩分析表的版本
+    ESLR1Parser comb(G);
+    comb.useCompressedTable();
+    comb.parse(stream, code);
+    auto t4 = steady_clock::now();
+    bool r3 = comb.parse(stream, code);
+    auto t5 = steady_clock::now();
+
+    assert(r0 && r1 && r2 && r3, "LR table test: parsing failed.");
+    assert(sameTree(legacy.getCST(), quiet.getCST()), "LR table test: CST differs (quiet).");
+    assert(sameTree(legacy.getCST(), packed.getCST()), "LR table test: CST differs.");
+    assert(sameTree(legacy.getCST(), comb.getCST()), "LR table test: CST differs (compressed).");
+    info << "Legacy parse: " << duration_cast<microseconds>(t1 - t0).count() << " us, "
+         << "quiet parse: " << duration_cast<microseconds>(q1 - q0).count() << " us, "
+         << "packed parse: " << duration_cast<microseconds>(t3 - t2).count() << " us, "
+         << "compressed parse: " << duration_cast<microseconds>(t5 - t4).count() << " us, "
+         << stream.size() << " tokens." << endl;
+    const ArenaTree &arena = packed.getArenaCST();
+    info << "Arena CST: " << arena.size() << " nodes, " << arena.bytes() << " bytes ("
+         << sizeof(pst_node_t) << " bytes per shared node before strings and productions)." << endl;
+
+    // 规约时直接构建AST，与CST->RST->AST逐步构建的结果相同
+    auto a0 = steady_clock::now();
+    packed.reduceCST();
+    packed.refactorRST();
+    auto a1 = steady_clock::now();
+    ESLR1Parser direct(G);
+    direct.useDirectAST();
+    direct.parse(stream, code);
+    auto a2 = steady_clock::now();
+    assert(direct.parse(stream, code), "LR table test: direct AST parsing failed.");
+    auto a3 = steady_clock::now();
+    assert(sameTree(packed.getAST(), direct.getAST()), "LR table test: direct AST differs.");
+    assert(sameTree(packed.getCST(), direct.getCST()), "LR table test: CST differs (direct AST).");
+    info << "CST->RST->AST: " << duration_cast<microseconds>(a1 - a0).count() << " us after parsing, "
+         << "direct AST parse: " << duration_cast<microseconds>(a3 - a2).count() << " us." << endl;
+
+    // 边词法分析边语法分析，CST与先切分再分析的结果相同
+    ESLR1Parser streamed(G);
+    assert(streamed.parse(lexer, code, false), "LR table test: streaming parsing failed.");
+    assert(sameTree(packed.getCST(), streamed.getCST()), "LR table test: CST differs (streaming).");
+    assert(streamed.parse(lexer, code), "LR table test: streaming parsing failed (async).");
+    assert(sameTree(packed.getCST(), streamed.getCST()), "LR table test: CST differs (async streaming).");
+    // 在较大的输入上比较先切分再分析与边切分边分析的耗时
+    string bigSrc;
+    for (size_t i = 0; i < 1000; i++)
+        bigSrc += code.getView();
+    Viewer big(move(bigSrc));
+    auto b0 = steady_clock::now();
+    TokenStream bigStream = lexer.scan(big);
+    G.transferTokens(bigStream);
+    assert(packed.parse(bigStream, big), "LR table test: parsing failed (large input).");
+    auto b1 = steady_clock::now();
+    assert(streamed.parse(lexer, big, false), "LR table test: streaming parsing failed (large input).");
+    auto b2 = steady_clock::now();
+    assert(streamed.parse(lexer, big), "LR table test: async streaming parsing failed (large input).");
+    auto b3 = steady_clock::now();
+    assert(packed.getArenaCST().size() == streamed.getArenaCST().size(), "LR table test: CST differs (large input).");
+    info << big.getView().size() << " bytes, " << bigStream.size() << " tokens: "
+         << "scan then parse: " << duration_cast<milliseconds>(b1 - b0).count() << " ms, "
+         << "streaming: " << duration_cast<milliseconds>(b2 - b1).count() << " ms, "
+         << "streaming with read-ahead: " << duration_cast<milliseconds>(b3 - b2).count() << " ms." << endl;
+
+    // SLR(1)分析程序
+    SLR1Parser slr1(G);
+    SLR1Parser slr1Comb(G);
+    tokens = G.transferTokens(lexer.tokenize(code));
+    assert(slr1.parse(tokens, code) && slr1Comb.parse(stream, code), "LR table test: SLR(1) parsing failed.");
+    assert(sameTree(slr1.getCST(), slr1Comb.getCST()), "LR table test: SLR(1) CST differs.");
+    info << "LR table test passed." << endl;
+}
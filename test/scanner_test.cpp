@@ -0,0 +1,135 @@
+/**
+ * @file scanner_test.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Test Generated Scanners
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "test.h"
+#include "lexer/lexer.h"
+#include "lexer/scanner_gen.h"
+#include "utils/log.h"
+
+#include <chrono>
+#include <random>
+#include <sstream>
+
+#ifdef SATORI_SCANNERS
+#include "cpp_scanner.h"
+#include "rsc_scanner.h"
+#include "psl_scanner.h"
+#endif
+
+// 比较生成的扫描器与Lexer::scan的结果，返回第一个不同的词法单元下标，完全相同时返回-1
+template <typename tokens_t>
+static size_t firstMismatch(const TokenStream &expected, const tokens_t &actual, const char *const *typeNames)
+{
+    size_t n = min(expected.size(), actual.size());
+    for (size_t i = 0; i < n; i++)
+    {
+        const token_span &e = expected[i];
+        if (*expected.type(i) != typeNames[actual[i].type] || e.offset != actual[i].offset || e.length != actual[i].length)
+            return i;
+    }
+    return expected.size() == actual.size() ? -1 : n;
+}
+
+// 随机修改源文本：替换字节、插入或删除片段，插入的内容大多取自源文本本身，以保留有意义的词法结构
+static string mutate(const string &src, mt19937 &rng)
+{
+    string s = src;
+    size_t edits = rng() % 8 + 1;
+    for (size_t e = 0; e < edits && !s.empty(); e++)
+    {
+        size_t pos = rng() % s.size();
+        switch (rng() % 4)
+        {
+        case 0:
+            s[pos] = src[rng() % src.size()];
+            break;
+        case 1:
+            s[pos] = (char)(rng() % 256);
+            break;
+        case 2:
+        {
+            size_t from = rng() % src.size();
+            s.insert(pos, src.substr(from, rng() % 32));
+            break;
+        }
+        default:
+            s.erase(pos, rng() % 16);
+            break;
+        }
+    }
+    return s;
+}
+
+template <typename scan_t>
+static void checkScanner(const string &lexFile, const string &srcFile, scan_t scan, const char *const *typeNames)
+{
+    using namespace std::chrono;
+    Lexer lexer(lexFile);
+    lexer.useCombinedAutomaton();
+    string src(Viewer::fromFile(srcFile).getView());
+    // 源文件本身
+    TokenStream expected = lexer.scan(Viewer(src));
+    auto actual = scan(src, nullptr);
+    size_t at = firstMismatch(expected, actual, typeNames);
+    assert(at == -1, format("Generated scanner mismatches Lexer on $ at token $.", srcFile, at));
+    info << srcFile << ": " << actual.size() << " tokens match." << endl;
+    // 随机变异的源文本，Lexer在匹配失败时会输出错误和上下文，比较期间暂时关闭输出
+    mt19937 rng(20261017);
+    size_t failed = 0, tokens = 0, mismatch = -1;
+    string bad;
+    streambuf *buf = cout.rdbuf(nullptr);
+    for (size_t i = 0; i < 300 && mismatch == -1; i++)
+    {
+        string fuzzed = mutate(src, rng);
+        size_t failures = 0;
+        TokenStream exp = lexer.scan(Viewer(fuzzed));
+        auto act = scan(fuzzed, &failures);
+        mismatch = firstMismatch(exp, act, typeNames);
+        failed += failures > 0;
+        tokens += act.size();
+        if (mismatch != -1)
+            bad = fuzzed;
+    }
+    cout.rdbuf(buf);
+    cout.clear();
+    assert(mismatch == -1, format("Generated scanner mismatches Lexer at token $ on fuzzed input:\n$", mismatch, bad));
+    info << srcFile << ": 300 fuzzed inputs match (" << tokens << " tokens, " << failed << " with unmatched input)." << endl;
+    // 速度对比
+    string big;
+    while (big.size() < (1 << 20))
+        big += src + "\n";
+    Viewer bigView(big);
+    auto t0 = steady_clock::now();
+    TokenStream bigExpected = lexer.scan(bigView);
+    auto t1 = steady_clock::now();
+    auto bigActual = scan(big, nullptr);
+    auto t2 = steady_clock::now();
+    assert(firstMismatch(bigExpected, bigActual, typeNames) == -1, "Generated scanner mismatches Lexer on large input.");
+    info << big.size() << " bytes, " << bigActual.size() << " tokens: Lexer " << duration_cast<microseconds>(t1 - t0).count()
+         << " us, generated scanner " << duration_cast<microseconds>(t2 - t1).count() << " us." << endl;
+}
+
+void scannerTest()
+{
+    Lexer lexer("./assets/lex/rsc.lex");
+    lexer.useCombinedAutomaton();
+    ScannerGenerator gen(lexer, "rsc");
+    string source = gen.source();
+    assert(source.find("size_t match(") != string::npos, "Generated scanner has no match function.");
+    info << "Generated rsc scanner: " << source.size() << " bytes of source." << endl;
+#ifdef SATORI_SCANNERS
+    checkScanner("./assets/lex/cpp.lex", "./assets/src/code.cpp", cpp_scanner::scan, cpp_scanner::typeNames);
+    checkScanner("./assets/lex/rsc.lex", "./assets/src/test.rsc", rsc_scanner::scan, rsc_scanner::typeNames);
+    checkScanner("./assets/lex/psl.lex", "./assets/src/roft.psl", psl_scanner::scan, psl_scanner::typeNames);
+#else
+    warn << "Generated scanners are not built (BUILD_SCANNERS is off), skip comparing with Lexer." << endl;
+#endif
+    info << "Scanner test passed." << endl;
+}
@@ -8,11 +8,16 @@
  *
  */
 
+#pragma once
+
+#include "common/tree/pst.h"
+
 using namespace std;
 
 void cstTest();
 void lexerTest();
 void nfaTest();
+void dfaTest();
 void parserTest();
 void logTest();
 void sptTest();
@@ -23,6 +28,27 @@ void slr1Test();
 void semTest();
 void metaTest();
 void eslrTest();
+void intGramTest();
+void lrTableTest();
+void compiledTest();
+void lalr1Test();
+void incrTest();
 void irgenTest();
 void lab5Test();
-void PSLTest();
\ No newline at end of file
+void PSLTest();
+void scannerTest();
+
+// 比较两棵语法树的结构、符号和位置是否完全相同
+inline bool sameTree(const pst_node_ptr_t &a, const pst_node_ptr_t &b)
+{
+    if (a->data.type != b->data.type || a->data.symbol != b->data.symbol)
+        return false;
+    if (a->data.line != b->data.line || a->data.col != b->data.col)
+        return false;
+    if (a->size() != b->size())
+        return false;
+    for (size_t i = 0; i < a->size(); i++)
+        if (!sameTree(a->getChildAt(i), b->getChildAt(i)))
+            return false;
+    return true;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file lexgen.cpp
+ * @author Zhenjie Wei (2024108@bjtu.edu.cn)
+ * @brief Scanner Generator Entry
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/**
+ * 构建时使用的扫描器生成工具（CMake目标SatoriLexGen）
+ * 用法：SatoriLexGen <.lex文件> <扫描器名> <输出目录>
+ * 在输出目录下生成<扫描器名>_scanner.h和<扫描器名>_scanner.cpp
+ */
+
+#include "lexer/lexer.h"
+#include "lexer/scanner_gen.h"
+#include "utils/log.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    if (argc != 4)
+    {
+        error << "Usage: " << argv[0] << " <lex file> <scanner name> <output dir>" << endl;
+        return 1;
+    }
+    setLogLevel(LOG_WARN);
+    Lexer lexer(argv[1]);
+    lexer.useCombinedAutomaton();
+    return ScannerGenerator(lexer, argv[2]).generate(argv[3]) ? 0 : 1;
+}